@@ -3,15 +3,21 @@
 
 #include "Reacoustic.h"
 #include "ReacousticSubsystem.h"
+#include "ReacousticLevelManifest.h"
+#include "Engine/World.h"
 
 void FReacousticModule::StartupModule()
 {
-	
+#if WITH_EDITOR
+	PreSaveWorldDelegateHandle = FWorldDelegates::OnPreSaveWorldWithContext.AddStatic(&UReacousticLevelManifest::HandlePreSaveWorld);
+#endif
 }
 
 void FReacousticModule::ShutdownModule()
 {
-	
+#if WITH_EDITOR
+	FWorldDelegates::OnPreSaveWorldWithContext.Remove(PreSaveWorldDelegateHandle);
+#endif
 }
 
 IMPLEMENT_MODULE(FReacousticModule, Reacoustic)
\ No newline at end of file
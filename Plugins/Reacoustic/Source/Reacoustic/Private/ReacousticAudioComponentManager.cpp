@@ -4,29 +4,184 @@
 #include "ReacousticAudioComponentManager.h"
 #include "ReacousticSubsystem.h"
 #include "Components/AudioComponent.h"
+#include "ReacousticStats.h"
 
 DEFINE_LOG_CATEGORY_CLASS(UReacousticAudioComponentManager, LogReacousticAudioComponentManager);
 
 void UReacousticAudioComponentManager::Initialize(UReacousticSubsystem* Subsystem)
 {
 	Super::Initialize(Subsystem);
-	
-	constexpr int32 AudioComponentAmount {32};
-	
-	for (int32 i {0}; i < AudioComponentAmount; ++i)
+
+	UWorld* World {Subsystem ? Subsystem->GetWorld() : nullptr};
+	if (!World)
+	{
+		UE_LOG(LogReacousticAudioComponentManager, Warning, TEXT("Failed to initialize ReacousticAudioComponentManager: no valid world."));
+		return;
+	}
+
+	PoolSize = Subsystem->Settings ? FMath::Max(Subsystem->Settings->VoicePoolSize, 1) : 32;
+	AvailableAudioComponents.Reserve(PoolSize);
+	ActiveVoices.Reserve(PoolSize);
+
+	for (int32 i {0}; i < PoolSize; ++i)
 	{
 		if (UAudioComponent* NewAudioComponent {NewObject<UAudioComponent>(Owner)})
 		{
+			NewAudioComponent->bAutoActivate = false;
+			NewAudioComponent->bAutoDestroy = false;
+			NewAudioComponent->bAllowSpatialization = true;
+			NewAudioComponent->OnAudioFinishedNative.AddUObject(this, &UReacousticAudioComponentManager::HandleVoiceFinished);
+			NewAudioComponent->RegisterComponentWithWorld(World);
 			AvailableAudioComponents.Add(NewAudioComponent);
 		}
 	}
 
-	if (AvailableAudioComponents.Num() != AudioComponentAmount)
+	if (AvailableAudioComponents.Num() != PoolSize)
 	{
-		UE_LOG(LogReacousticAudioComponentManager, Warning, TEXT("Failed to populate AudioComponent pool. Expected: '%d', Created: '%d'"), AudioComponentAmount, AvailableAudioComponents.Num());
+		UE_LOG(LogReacousticAudioComponentManager, Warning, TEXT("Failed to populate AudioComponent pool. Expected: '%d', Created: '%d'"), PoolSize, AvailableAudioComponents.Num());
 	}
 	else
 	{
 		UE_LOG(LogReacousticAudioComponentManager, Log, TEXT("Successfully initialized ReacousticAudioComponentManager"));
 	}
 }
+
+void UReacousticAudioComponentManager::Deinitialize(UReacousticSubsystem* Subsystem)
+{
+	for (const FReacousticVoice& Voice : ActiveVoices)
+	{
+		AvailableAudioComponents.Add(Voice.AudioComponent);
+	}
+	ActiveVoices.Empty();
+
+	for (UAudioComponent* AudioComponent : AvailableAudioComponents)
+	{
+		if (AudioComponent)
+		{
+			AudioComponent->OnAudioFinishedNative.RemoveAll(this);
+			AudioComponent->Stop();
+			AudioComponent->DestroyComponent();
+		}
+	}
+	AvailableAudioComponents.Empty();
+
+	Super::Deinitialize(Subsystem);
+}
+
+UAudioComponent* UReacousticAudioComponentManager::AcquireVoice(const float Priority, const FVector& Location)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(Reacoustic::AcquireVoice);
+
+	if (AvailableAudioComponents.IsEmpty())
+	{
+		ReclaimFinishedVoices();
+	}
+
+	UAudioComponent* AudioComponent {nullptr};
+	while (!AudioComponent && !AvailableAudioComponents.IsEmpty())
+	{
+		AudioComponent = AvailableAudioComponents.Pop(false);
+	}
+
+	/** Steal the voice with the lowest priority if the pool is exhausted. */
+	if (!AudioComponent)
+	{
+		int32 LowestPriorityIndex {INDEX_NONE};
+		float LowestPriority {Priority};
+		for (int32 Index {0}; Index < ActiveVoices.Num(); ++Index)
+		{
+			if (ActiveVoices[Index].Priority < LowestPriority)
+			{
+				LowestPriority = ActiveVoices[Index].Priority;
+				LowestPriorityIndex = Index;
+			}
+		}
+
+		if (LowestPriorityIndex == INDEX_NONE) { return nullptr; }
+
+		AudioComponent = ActiveVoices[LowestPriorityIndex].AudioComponent;
+		ActiveVoices.RemoveAtSwap(LowestPriorityIndex, 1, false);
+
+		if (!AudioComponent) { return nullptr; }
+		AudioComponent->Stop();
+	}
+
+	AudioComponent->SetWorldLocation(Location);
+	ActiveVoices.Emplace(AudioComponent, Priority, GFrameCounter);
+	return AudioComponent;
+}
+
+void UReacousticAudioComponentManager::ReleaseVoice(UAudioComponent* AudioComponent)
+{
+	if (!AudioComponent) { return; }
+
+	const int32 Index {ActiveVoices.IndexOfByPredicate([AudioComponent](const FReacousticVoice& Voice)
+	{
+		return Voice.AudioComponent == AudioComponent;
+	})};
+
+	if (Index == INDEX_NONE) { return; }
+
+	ActiveVoices.RemoveAtSwap(Index, 1, false);
+	if (AudioComponent->IsPlaying())
+	{
+		AudioComponent->Stop();
+	}
+	AvailableAudioComponents.Add(AudioComponent);
+}
+
+float UReacousticAudioComponentManager::CalculateVoicePriority(const float ImpactStrength, const FVector& Location) const
+{
+	/** The listener location is cached by the subsystem once per frame. */
+	FVector ListenerLocation;
+	if (!GetOwner() || !GetOwner()->GetListenerLocation(ListenerLocation)) { return ImpactStrength; }
+
+	const float DistanceInMeters {static_cast<float>(FVector::Distance(ListenerLocation, Location)) / 100.0f};
+	return ImpactStrength / FMath::Max(DistanceInMeters, 1.0f);
+}
+
+TArray<UAudioComponent*> UReacousticAudioComponentManager::GetActiveAudioComponents() const
+{
+	TArray<UAudioComponent*> AudioComponents;
+	AudioComponents.Reserve(ActiveVoices.Num());
+	for (const FReacousticVoice& Voice : ActiveVoices)
+	{
+		AudioComponents.Add(Voice.AudioComponent);
+	}
+	return AudioComponents;
+}
+
+void UReacousticAudioComponentManager::ReclaimFinishedVoices()
+{
+	for (int32 Index {ActiveVoices.Num() - 1}; Index >= 0; --Index)
+	{
+		const FReacousticVoice& Voice {ActiveVoices[Index]};
+		if (Voice.AcquireFrame == GFrameCounter) { continue; }
+
+		if (!Voice.AudioComponent || !Voice.AudioComponent->IsPlaying())
+		{
+			if (Voice.AudioComponent)
+			{
+				AvailableAudioComponents.Add(Voice.AudioComponent);
+			}
+			ActiveVoices.RemoveAtSwap(Index, 1, false);
+		}
+	}
+}
+
+/** The finished notification of a stolen voice can arrive after the voice has already been acquired again,
+ *	so we only return the voice to the pool if it is not playing and was not acquired during this frame. */
+void UReacousticAudioComponentManager::HandleVoiceFinished(UAudioComponent* AudioComponent)
+{
+	if (!AudioComponent || AudioComponent->IsPlaying()) { return; }
+
+	const int32 Index {ActiveVoices.IndexOfByPredicate([AudioComponent](const FReacousticVoice& Voice)
+	{
+		return Voice.AudioComponent == AudioComponent;
+	})};
+
+	if (Index == INDEX_NONE || ActiveVoices[Index].AcquireFrame == GFrameCounter) { return; }
+
+	ActiveVoices.RemoveAtSwap(Index, 1, false);
+	AvailableAudioComponents.Add(AudioComponent);
+}
@@ -5,7 +5,11 @@
 
 #include "FileCache.h"
 #include "ReacousticSubsystem.h"
+#include "ReacousticAudioComponentManager.h"
+#include "ReacousticSoundStreamingManager.h"
 #include "Chaos/Utilities.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+#include "ReacousticStats.h"
 
 DEFINE_LOG_CATEGORY_CLASS(UReacousticComponent, LogReacousticComponent);
 
@@ -19,9 +23,10 @@ void UReacousticComponent::BeginPlay()
 	Super::BeginPlay();
 	if(const UWorld* World {GetWorld()})
 	{
-		if(UReacousticSubsystem* Subsystem {World->GetSubsystem<UReacousticSubsystem>()})
+		OwningSubsystem = World->GetSubsystem<UReacousticSubsystem>();
+		if(OwningSubsystem)
 		{
-			Subsystem->RegisterComponent(this);
+			OwningSubsystem->RegisterComponent(this);
 		}
 	}
 	else
@@ -62,6 +67,16 @@ void UReacousticComponent::BeginPlay()
 	if(MeshComponent)
 	{
 		MeshComponent->OnComponentHit.AddDynamic(this, &UReacousticComponent::HandleOnComponentHit);
+
+		/** Sleeping bodies do not need hit notifications. They are enabled again as soon as the body wakes up. */
+		if (OwningSubsystem && OwningSubsystem->Settings && OwningSubsystem->Settings->UseSleepAwareHitNotifications)
+		{
+			ManagesHitNotifications = true;
+			MeshComponent->BodyInstance.bGenerateWakeEvents = true;
+			MeshComponent->OnComponentWake.AddDynamic(this, &UReacousticComponent::HandleMeshWake);
+			MeshComponent->OnComponentSleep.AddDynamic(this, &UReacousticComponent::HandleMeshSleep);
+			SetWantsHitNotifications(MeshComponent->IsAnyRigidBodyAwake());
+		}
 	}
 	else
 	{
@@ -77,26 +92,45 @@ inline void UReacousticComponent::Initialize_Implementation(USoundBase* SoundBas
 	{
 		if(UReacousticSubsystem* Subsystem {World->GetSubsystem<UReacousticSubsystem>()})
 		{
-			TransferData(Subsystem->ReacousticSoundDataAsset,Subsystem->ReacousticSoundDataRefMap,Subsystem->GetMeshSoundData(MeshComponent));
+			TransferDataHandle(Subsystem->ReacousticSoundDataAsset, Subsystem->ReacousticSoundDataRefMap, Subsystem->FindMeshSoundDataHandle(MeshComponent));
 		}
 	}
-	
-	if(!AudioComponent)
-	{
-		AudioComponent = NewObject<UAudioComponent>(GetOwner());
-		AudioComponent->RegisterComponent();
-		AudioComponent->SetSound(SoundBase);
-	}
-	
+
+	/** The sound is played on a pooled voice when a hit occurs, instead of on an AudioComponent owned by this actor. */
+	ImpactSound = SoundBase;
+}
+
+UAudioComponent* UReacousticComponent::AcquireImpactVoice(float ImpactStrength, const FVector& Location)
+{
+	const UWorld* World {GetWorld()};
+	const UReacousticSubsystem* Subsystem {World ? World->GetSubsystem<UReacousticSubsystem>() : nullptr};
+	UReacousticAudioComponentManager* AudioComponentManager {Subsystem ? Subsystem->GetAudioComponentManager() : nullptr};
+	if (!AudioComponentManager) { return nullptr; }
+
+	AudioComponent = AudioComponentManager->AcquireVoice(AudioComponentManager->CalculateVoicePriority(ImpactStrength, Location), Location);
+	if (!AudioComponent) { return nullptr; }
+
+	AudioComponent->SetSound(ImpactSound);
+
+	const FReacousticSoundData* SoundData {GetSoundData()};
+	if (!SoundData) { return AudioComponent; }
+
 	/** Set the attenuation settings */
-	AudioComponent->AttenuationSettings = MeshAudioData.Attenuation;
+	AudioComponent->AttenuationSettings = SoundData->Attenuation;
+
+	/** Blend the surface sound in by its dampening percentage. Without surface sound data, or while its wave is still loading, only the object sound is heard. */
+	const FReacousticSoundData* SurfaceSoundData {GetSurfaceSoundData()};
+	USoundWave* SurfaceWave {SurfaceSoundData ? SurfaceSoundData->ImpactWaveAsset.Get() : nullptr};
+	const float SurfaceMix {SurfaceWave ? FMath::Clamp(SurfaceSoundData->SurfaceDampeningPercentage, 0.0f, 100.0f) / 100.0f : 0.0f};
+	const float ImpulseLength {SurfaceWave ? FMath::Lerp(SoundData->ImpulseLength, SurfaceSoundData->ImpulseLength, SurfaceMix) : SoundData->ImpulseLength};
 
 	/** Set the parameters.*/
-	AudioComponent->SetFloatParameter(TEXT("Obj_Length"), MeshAudioData.ImpulseLength);
-	AudioComponent->SetWaveParameter(TEXT("Obj_WaveAsset"), MeshAudioData.ImpactWaveAsset);
+	AudioComponent->SetFloatParameter(TEXT("Obj_Length"), ImpulseLength);
+	AudioComponent->SetWaveParameter(TEXT("Obj_WaveAsset"), SoundData->ImpactWaveAsset.Get());
+	AudioComponent->SetWaveParameter(TEXT("Srf_WaveAsset"), SurfaceWave);
+	AudioComponent->SetFloatParameter(TEXT("Srf_Mix"), SurfaceMix);
 
-	/** Add the audio component to the parent actor */
-	AudioComponent->AttachToComponent(GetOwner()->GetRootComponent(), FAttachmentTransformRules::KeepRelativeTransform);
+	return AudioComponent;
 }
 
 float UReacousticComponent::CalculateImpactValue(const FVector& NormalImpulse, const UPrimitiveComponent* HitComponent,
@@ -104,26 +138,91 @@ float UReacousticComponent::CalculateImpactValue(const FVector& NormalImpulse, c
 {
 	if (!HitComponent || !HitComponent->IsSimulatingPhysics() || !OtherActor) {return 0.0f; }
 
+	/** Rotation is not taken into account, since it results in unpredictable sound. */
 	const FVector RelativeVelocity {HitComponent->GetComponentVelocity() - OtherActor->GetVelocity()};
-	//Rotation is currently not used since it results in unpredicable sound.
-	const float RotationalSpeed = FMath::Abs(HitComponent->GetMass()*HitComponent->GetPhysicsAngularVelocityInRadians().Length());
-	const FVector ScaledImpulse {(NormalImpulse + RelativeVelocity)};
+	return CalculateImpactStrength(NormalImpulse, RelativeVelocity);
+}
+
+float UReacousticComponent::CalculateImpactStrength(const FVector& NormalImpulse, const FVector& RelativeVelocity)
+{
 	const float D = FMath::Abs(FVector::DotProduct(RelativeVelocity.GetSafeNormal(), NormalImpulse.GetSafeNormal()));
-	return  RelativeVelocity.Length()*D;
+	return RelativeVelocity.Length()*D;
 }
 
 FReacousticSoundData UReacousticComponent::GetSurfaceHitSoundX(const AActor* Actor, const UPhysicalMaterial* PhysicalMaterial)
 {
-	return FReacousticSoundData();
+	const UWorld* World {Actor ? Actor->GetWorld() : nullptr};
+	const UReacousticSubsystem* Subsystem {World ? World->GetSubsystem<UReacousticSubsystem>() : nullptr};
+	if (!Subsystem || !Subsystem->ReacousticSoundDataAsset) { return FReacousticSoundData(); }
+
+	const FReacousticSoundDataHandle Handle {Subsystem->FindSurfaceSoundDataHandle(UPhysicalMaterial::DetermineSurfaceType(PhysicalMaterial))};
+	const FReacousticSoundData* SoundData {Subsystem->ReacousticSoundDataAsset->Find(Handle)};
+	return SoundData ? *SoundData : FReacousticSoundData();
+}
+
+void UReacousticComponent::ResolveImpactSurface(const FHitResult& Hit)
+{
+	SurfaceSoundDataHandle = FReacousticSoundDataHandle{};
+	if (!OwningSubsystem || !OwningSubsystem->IsSurfaceAudioEnabled()) { return; }
+
+	const UPhysicalMaterial* PhysicalMaterial {Hit.PhysMaterial.Get()};
+
+	/** Only request the physical material when the hit does not carry one, and only for the component that was hit. */
+	if (!PhysicalMaterial && Hit.Component.IsValid())
+	{
+		FCollisionQueryParams QueryParams {SCENE_QUERY_STAT(ReacousticSurfaceTrace), true};
+		QueryParams.bReturnPhysicalMaterial = true;
+
+		const FVector TraceOffset {Hit.ImpactNormal * 10.0};
+		FHitResult SurfaceHit;
+		if (Hit.Component->LineTraceComponent(SurfaceHit, Hit.ImpactPoint + TraceOffset, Hit.ImpactPoint - TraceOffset, QueryParams))
+		{
+			PhysicalMaterial = SurfaceHit.PhysMaterial.Get();
+		}
+	}
+
+	if (!PhysicalMaterial) { return; }
+
+	SurfaceSoundDataHandle = OwningSubsystem->FindSurfaceSoundDataHandle(UPhysicalMaterial::DetermineSurfaceType(PhysicalMaterial));
+}
+
+const FReacousticSoundData* UReacousticComponent::GetSurfaceSoundData() const
+{
+	return ReacousticSoundDataAsset ? ReacousticSoundDataAsset->Find(SurfaceSoundDataHandle) : nullptr;
 }
 
+/** Hits are queued in the subsystem and filtered in a single batched pass at the end of the frame. */
 void UReacousticComponent::HandleOnComponentHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
 {
-	if(FilterImpact(HitComp,OtherActor,OtherComp,NormalImpulse,Hit))
+	TRACE_CPUPROFILER_EVENT_SCOPE(Reacoustic::HandleOnComponentHit);
+	if (OwningSubsystem)
 	{
-		OnComponentHit(HitComp, OtherActor, OtherComp, NormalImpulse, Hit);
+		OwningSubsystem->QueueImpact(this, HitComp, OtherActor, OtherComp, NormalImpulse, Hit);
 	}
+	else if(FilterImpact(CalculateImpactValue(NormalImpulse, HitComp, OtherActor), Hit))
+	{
+		PlayImpact(HitComp, OtherActor, OtherComp, NormalImpulse, Hit);
+	}
+}
+
+bool UReacousticComponent::PlayImpact(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, const FVector& NormalImpulse, const FHitResult& Hit)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(Reacoustic::PlayImpact);
+	LatestOnsetTimestamp = -1.0f;
+
+	ResolveImpactSurface(Hit);
+
+	/** Soft surfaces dampen the impact of the object. */
+	if (const FReacousticSoundData* SurfaceSoundData {GetSurfaceSoundData()})
+	{
+		ImpactForce *= 1.0f - FMath::Clamp(SurfaceSoundData->SurfaceDampeningPercentage, 0.0f, 100.0f) / 100.0f;
+	}
+
+	/** Drop the impact if all voices are in use by louder or closer impacts. */
+	if (!AcquireImpactVoice(ImpactForce, Hit.ImpactPoint)) { return false; }
 	
+	OnComponentHit(HitComp, OtherActor, OtherComp, NormalImpulse, Hit);
+	return true;
 }
 
 
@@ -147,13 +246,14 @@ double UReacousticComponent::ReturnDeltaLocationDistance()
 	return DeltaLocationDistance;
 }
 
-void UReacousticComponent::TransferData(UReacousticSoundDataAsset* SoundDataArray, UReacousticSoundDataRef_Map* ReferenceMap, FReacousticSoundData MeshSoundDataIn)
+void UReacousticComponent::TransferData(UReacousticSoundDataAsset* SoundDataArray, UReacousticSoundDataRef_Map* ReferenceMap, const FReacousticSoundData& MeshSoundDataIn)
 {
 	if(SoundDataArray && ReferenceMap)
 	{
 		ReacousticSoundDataAsset = SoundDataArray;
 		UReacousticSoundDataRefMap = ReferenceMap;
-		MeshAudioData = MeshSoundDataIn;
+		SoundDataHandle = FReacousticSoundDataHandle{};
+		CustomSoundData = MakeShared<const FReacousticSoundData>(MeshSoundDataIn);
 	}
 	else
 	{
@@ -162,24 +262,121 @@ void UReacousticComponent::TransferData(UReacousticSoundDataAsset* SoundDataArra
 	
 }
 
-inline static float GetArraySum(const TArray<float>& Array)
+void UReacousticComponent::TransferDataHandle(UReacousticSoundDataAsset* SoundDataArray, UReacousticSoundDataRef_Map* ReferenceMap, FReacousticSoundDataHandle Handle)
+{
+	if (!SoundDataArray || !ReferenceMap)
+	{
+		UE_LOG(LogReacousticComponent, Warning, TEXT("Warning, failed to trasfer data to %s"), *GetOwner()->GetName());
+		return;
+	}
+
+	ReacousticSoundDataAsset = SoundDataArray;
+	UReacousticSoundDataRefMap = ReferenceMap;
+	SoundDataHandle = Handle;
+	CustomSoundData.Reset();
+}
+
+const FReacousticSoundData* UReacousticComponent::GetSoundData() const
 {
-	float Sum {0.0};
-	for (const float Element : Array)
+	if (CustomSoundData)
 	{
-		Sum += Element;
+		return CustomSoundData.Get();
 	}
-	return Sum;
+	return ReacousticSoundDataAsset ? ReacousticSoundDataAsset->Find(SoundDataHandle) : nullptr;
+}
+
+FReacousticSoundData UReacousticComponent::GetMeshAudioData() const
+{
+	const FReacousticSoundData* SoundData {GetSoundData()};
+	return SoundData ? *SoundData : FReacousticSoundData{};
+}
+
+void UReacousticComponent::SetMeshAudioData(const FReacousticSoundData& SoundData)
+{
+	SoundDataHandle = FReacousticSoundDataHandle{};
+	CustomSoundData = MakeShared<const FReacousticSoundData>(SoundData);
+}
+
+bool UReacousticComponent::RequestImpactWave() const
+{
+	const FReacousticSoundData* SoundData {GetSoundData()};
+	if (!SoundData || SoundData->ImpactWaveAsset.IsNull()) { return true; }
+
+	UReacousticSoundStreamingManager* SoundStreamingManager {OwningSubsystem ? OwningSubsystem->GetSoundStreamingManager() : nullptr};
+	return SoundStreamingManager ? SoundStreamingManager->RequestWave(SoundData->ImpactWaveAsset) != nullptr : SoundData->ImpactWaveAsset.LoadSynchronous() != nullptr;
+}
+
+bool UReacousticComponent::IsAudibleFrom(const FVector& ListenerLocation, const FVector& Location) const
+{
+	const FReacousticSoundData* SoundData {GetSoundData()};
+	if (!SoundData || !SoundData->Attenuation || !SoundData->Attenuation->Attenuation.bAttenuate) { return true; }
+
+	const float AudibleRadius {SoundData->Attenuation->Attenuation.GetMaxDimension()};
+	return FVector::DistSquared(ListenerLocation, Location) <= FMath::Square(AudibleRadius);
+}
+
+void UReacousticComponent::UpdateHitNotifications(const bool HasListener, const FVector& ListenerLocation, const float SpeedThresholdSquared, const float ListenerRadiusSquared)
+{
+	if (!ManagesHitNotifications || !MeshComponent) { return; }
+
+	if (!MeshComponent->IsAnyRigidBodyAwake())
+	{
+		SetWantsHitNotifications(false);
+		return;
+	}
+
+	const bool IsMoving {MeshComponent->GetPhysicsLinearVelocity().SizeSquared() > SpeedThresholdSquared};
+	const bool IsNearListener {HasListener && FVector::DistSquared(ListenerLocation, MeshComponent->GetComponentLocation()) < ListenerRadiusSquared};
+	SetWantsHitNotifications(IsMoving || IsNearListener);
+}
+
+void UReacousticComponent::SetWantsHitNotifications(const bool InWantsHitNotifications)
+{
+	if (!MeshComponent || WantsHitNotifications == InWantsHitNotifications) { return; }
+
+	/** Another component is managing the hit notifications, for example while the prop is held. Remember the state it has set,
+	 *	so that the next request is compared against the actual state once that component is gone. */
+	if (OwningSubsystem && OwningSubsystem->HasHitNotificationOwnerComponent(GetOwner()))
+	{
+		WantsHitNotifications = MeshComponent->BodyInstance.bNotifyRigidBodyCollision;
+		return;
+	}
+
+	WantsHitNotifications = InWantsHitNotifications;
+	if (MeshComponent->IsSimulatingPhysics())
+	{
+		MeshComponent->SetNotifyRigidBodyCollision(WantsHitNotifications);
+	}
+}
+
+void UReacousticComponent::HandleMeshWake(UPrimitiveComponent* WakingComponent, FName BoneName)
+{
+	SetWantsHitNotifications(true);
+}
+
+void UReacousticComponent::HandleMeshSleep(UPrimitiveComponent* SleepingComponent, FName BoneName)
+{
+	SetWantsHitNotifications(false);
+}
+
+SIZE_T UReacousticComponent::GetSoundDataMemoryUsage() const
+{
+	SIZE_T MemoryUsage {sizeof(SoundDataHandle) + sizeof(CustomSoundData)};
+	if (CustomSoundData)
+	{
+		MemoryUsage += CustomSoundData->GetMemoryUsage();
+	}
+	return MemoryUsage;
 }
 
 /** Filter the hit events so that the system only triggers at appropriate impacts.*/
-//TODO: i'm passing a lot of values that i might not need. So i'll delete them later.
-bool UReacousticComponent::FilterImpact(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
+bool UReacousticComponent::FilterImpact(const float ImpactStrength, const FHitResult& Hit)
 {
+	TRACE_CPUPROFILER_EVENT_SCOPE(Reacoustic::FilterImpact);
 	bool HitIsValid{false};
-	ImpactForce = CalculateImpactValue(NormalImpulse,HitComp,OtherActor);
+	ImpactForce = ImpactStrength;
 	/** We perform a lot of filtering to prevent hitsounds from playing in unwanted situations.*/
-	if( ImpactForce > 30)
+	if( ImpactForce > MinimumImpactStrength)
 	{
 		DeltaLocationDistance = abs(FVector::Distance(LatestLocation, Hit.Location));
 		LatestLocation = Hit.ImpactPoint;
@@ -194,7 +391,7 @@ bool UReacousticComponent::FilterImpact(UPrimitiveComponent* HitComp, AActor* Ot
 			/** If there's a considerable time between hits, remove the hit state history.*/
 			if(DeltaHitTime > 1.0)
 			{
-				DeltaStateArray.Empty();
+				DeltaStateArray.Reset();
 			}
 			
 			if(DeltaHitTime > 0.05)
@@ -213,8 +410,8 @@ bool UReacousticComponent::FilterImpact(UPrimitiveComponent* HitComp, AActor* Ot
 				{
 					/** Prevent more erratic hits happening for a long time in the same location. Eg: An object glitching behind the wall.*/
 					DeltaStateArray.Add(DeltaLocationDistance * DeltaHitTime + 100*DeltaDirectionVector);
-					UE_LOG(LogReacousticComponent, Verbose, TEXT("DeltaStateArray Array Sum: %f"),(GetArraySum(DeltaStateArray)));
-					if(GetArraySum(DeltaStateArray) > 0.5f || DeltaStateArray.Num() <= 20)
+					UE_LOG(LogReacousticComponent, Verbose, TEXT("DeltaStateArray Array Sum: %f"),(DeltaStateArray.GetSum()));
+					if(DeltaStateArray.GetSum() > 0.5f || DeltaStateArray.Num() <= DeltaStateHistoryLength)
 					{
 							HitIsValid = true;
 					}
@@ -225,63 +422,31 @@ bool UReacousticComponent::FilterImpact(UPrimitiveComponent* HitComp, AActor* Ot
 			else{UE_LOG(LogReacousticComponent,Verbose,TEXT("Prevented hit by: DELTA HIT TIME"))}
 		}
 		else{UE_LOG(LogReacousticComponent,Verbose,TEXT("Prevented hit by: LOCATION DISTANCE"))}
-		
-		/** Remove the oldest delta location distance from the array if it exceeds the limit. */
-		if (DeltaStateArray.Num() > 20)
-		{
-			DeltaStateArray.RemoveAt(0);
-		}
 	}
 	return HitIsValid;
 }
 
 
-/**Iterate through SounData.OnsetDataMap(timestamp,volume) to find a timestamp related to a volume matching the impact value.*/
-int UReacousticComponent::FindTimeStampEntry(FReacousticSoundData SoundData, float ImpactValue)
+/** Find a timestamp in SoundData.OnsetDataMap(timestamp,volume) related to a volume matching the impact value.*/
+int UReacousticComponent::FindTimeStampEntry(const FReacousticSoundData& SoundData, float ImpactValue)
 {
-	
-	float BestDifference = FLT_MAX; 
-	int BestTimeStamp = -1;
+	const float TimeStamp {FindOnsetTimestamp(SoundData, ImpactValue)};
+	return TimeStamp < 0.0f ? -1 : static_cast<int>(TimeStamp);
+}
 
-	/** Iterate over TMap and find the key asociated with the volume value closest to impact value */
-	for(auto& Elem : SoundData.OnsetDataMap)
-	{
-		/** If this element is in LatestMatchingElements, skip to the next iteration */
-		/** Iterate throug the recorded sound timestamps.*/
-		bool next{false};
-		for (int32 j = 0; j < LatestMatchingElements.Num(); j++)
-		{
-			float LatestMatchingElement = LatestMatchingElements[j];
-			/** if any of them don't fit, break and test the next timestamp.*/
-			if (FMath::Abs(Elem.Value - LatestMatchingElement) < SoundData.ImpulseLength*2)
-			{
-				next = true;
-				break;
-			}
-		}
-		if(next)
-		{
-			continue;
-		}
-		const float CurrentDifference = FMath::Abs(ImpactValue - Elem.Value);
-		if(CurrentDifference < BestDifference)
-		{
-			BestDifference = CurrentDifference;
-			BestTimeStamp = Elem.Value;
-		}
-	}
+float UReacousticComponent::FindOnsetTimestamp(const FReacousticSoundData& SoundData, float ImpactValue)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(Reacoustic::FindOnsetTimestamp);
 
-	/** If we found a matching timestamp, update LatestMatchingElements */
-	if(BestTimeStamp != -1)
-	{
-		LatestMatchingElements.Add(BestTimeStamp);
-        
-		/** If we now have more than 10 elements, remove the oldest one */
-		if(LatestMatchingElements.Num() > 10)
-		{
-			LatestMatchingElements.RemoveAt(0);
-		}
-	}
+	const FReacousticOnsetIndex& OnsetIndex {SoundData.GetOnsetIndex()};
+	
+	/** Onsets that are close in time to a recently used onset are skipped to prevent multiple triggers of the same sound. */
+	const int32 BestIndex {OnsetIndex.FindBestOnset(ImpactValue, LatestMatchingElementBuffer.GetElementsUnordered(), SoundData.ImpulseLength * 2)};
+	if (BestIndex == INDEX_NONE) { return -1.0f; }
+
+	const float BestTimeStamp {OnsetIndex.GetTimestamp(BestIndex)};
+	LatestMatchingElementBuffer.Add(BestTimeStamp);
+	LatestOnsetTimestamp = BestTimeStamp;
 
 	return BestTimeStamp;
 }
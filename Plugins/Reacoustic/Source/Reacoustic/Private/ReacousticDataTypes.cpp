@@ -0,0 +1,224 @@
+// Copyright (c) 2022-present Nino Saglia. All Rights Reserved.
+// Written by Nino Saglia.
+
+#include "ReacousticDataTypes.h"
+#include "Algo/BinarySearch.h"
+#include "HAL/IConsoleManager.h"
+
+void FReacousticOnsetIndex::Build(const TMap<float, float>& OnsetDataMap)
+{
+	TArray<TPair<float, float>> Onsets;
+	Onsets.Reserve(OnsetDataMap.Num());
+	float MaxVolume {0.0f};
+	float MaxTimestamp {0.0f};
+	for (const TPair<float, float>& Onset : OnsetDataMap)
+	{
+		Onsets.Emplace(Onset.Value, Onset.Key);
+		MaxVolume = FMath::Max(MaxVolume, Onset.Value);
+		MaxTimestamp = FMath::Max(MaxTimestamp, Onset.Key);
+	}
+	Onsets.Sort([](const TPair<float, float>& A, const TPair<float, float>& B) { return A.Key < B.Key; });
+
+	constexpr float QuantizedMax {static_cast<float>(MAX_uint16)};
+	VolumeScale = MaxVolume / QuantizedMax;
+	TimestampScale = MaxTimestamp / QuantizedMax;
+
+	auto Quantize = [](const float Value, const float Scale) -> uint16
+	{
+		return Scale > 0.0f ? static_cast<uint16>(FMath::Clamp(FMath::RoundToInt(Value / Scale), 0, static_cast<int32>(MAX_uint16))) : 0;
+	};
+
+	QuantizedOnsets.SetNumUninitialized(Onsets.Num() * 2);
+	for (int32 Index {0}; Index < Onsets.Num(); ++Index)
+	{
+		QuantizedOnsets[Index] = Quantize(Onsets[Index].Key, VolumeScale);
+		QuantizedOnsets[Onsets.Num() + Index] = Quantize(Onsets[Index].Value, TimestampScale);
+	}
+}
+
+int32 FReacousticOnsetIndex::FindBestOnset(const float Volume, TArrayView<const float> ExcludedTimestamps, const float ExclusionRadius) const
+{
+	if (IsEmpty()) { return INDEX_NONE; }
+
+	auto IsExcluded = [&](const int32 Index)
+	{
+		const float Timestamp {GetTimestamp(Index)};
+		for (const float ExcludedTimestamp : ExcludedTimestamps)
+		{
+			if (FMath::Abs(Timestamp - ExcludedTimestamp) < ExclusionRadius)
+			{
+				return true;
+			}
+		}
+		return false;
+	};
+
+	/** Walk outwards from the closest match, always testing the closer of the two neighbours first.
+	 *	The first onset that is not excluded is therefore the best match. */
+	const TArrayView<const uint16> Volumes {GetQuantizedVolumes()};
+	const float QuantizedVolume {VolumeScale > 0.0f ? Volume / VolumeScale : 0.0f};
+	int32 Right {static_cast<int32>(Algo::LowerBoundBy(Volumes, QuantizedVolume, [](const uint16 Value) { return static_cast<float>(Value); }))};
+	int32 Left {Right - 1};
+	
+	for (int32 ProbeCount {0}; ProbeCount < MaxProbeCount; ++ProbeCount)
+	{
+		const bool HasLeft {Left >= 0};
+		const bool HasRight {Right < Volumes.Num()};
+		if (!HasLeft && !HasRight) { break; }
+
+		int32 Candidate;
+		if (HasLeft && (!HasRight || QuantizedVolume - Volumes[Left] <= Volumes[Right] - QuantizedVolume))
+		{
+			Candidate = Left--;
+		}
+		else
+		{
+			Candidate = Right++;
+		}
+
+		if (!IsExcluded(Candidate))
+		{
+			return Candidate;
+		}
+	}
+	return INDEX_NONE;
+}
+
+bool FReacousticOnsetIndex::Serialize(FArchive& Ar)
+{
+	Ar << VolumeScale;
+	Ar << TimestampScale;
+	QuantizedOnsets.BulkSerialize(Ar);
+	return true;
+}
+
+/** The linear onset search that FindBestOnset replaced. Used as the baseline of the onset lookup benchmark. */
+static float FindOnsetTimestampLinear(const TMap<float, float>& OnsetDataMap, const float Volume, TArrayView<const float> ExcludedTimestamps, const float ExclusionRadius)
+{
+	float BestDifference {FLT_MAX};
+	float BestTimestamp {-1.0f};
+	for (const TPair<float, float>& Onset : OnsetDataMap)
+	{
+		bool IsExcluded {false};
+		for (const float ExcludedTimestamp : ExcludedTimestamps)
+		{
+			if (FMath::Abs(Onset.Key - ExcludedTimestamp) < ExclusionRadius)
+			{
+				IsExcluded = true;
+				break;
+			}
+		}
+		if (IsExcluded) { continue; }
+
+		const float Difference {FMath::Abs(Volume - Onset.Value)};
+		if (Difference < BestDifference)
+		{
+			BestDifference = Difference;
+			BestTimestamp = Onset.Key;
+		}
+	}
+	return BestTimestamp;
+}
+
+/** Compares the linear onset search with the onset index for a sound with a given amount of random onsets. */
+static void BenchmarkOnsetLookup(const int32 OnsetCount, const int32 Iterations)
+{
+	constexpr int32 ExcludedCount {10};
+	constexpr float ExclusionRadius {0.02f};
+
+	FRandomStream RandomStream {OnsetCount};
+	TMap<float, float> OnsetDataMap;
+	OnsetDataMap.Reserve(OnsetCount);
+	while (OnsetDataMap.Num() < OnsetCount)
+	{
+		OnsetDataMap.Add(RandomStream.FRandRange(0.0f, 0.01f * OnsetCount), RandomStream.FRand());
+	}
+
+	FReacousticOnsetIndex OnsetIndex;
+	OnsetIndex.Build(OnsetDataMap);
+
+	TArray<float> Volumes;
+	Volumes.SetNumUninitialized(Iterations);
+	for (float& Volume : Volumes)
+	{
+		Volume = RandomStream.FRand();
+	}
+
+	/** Both searches keep the ten most recently used timestamps excluded, like UReacousticComponent does. */
+	TArray<float> ExcludedTimestamps;
+	ExcludedTimestamps.Init(-1.0f, ExcludedCount);
+
+	int32 LinearFoundCount {0};
+	const double LinearStartTime {FPlatformTime::Seconds()};
+	for (int32 Iteration {0}; Iteration < Iterations; ++Iteration)
+	{
+		const float Timestamp {FindOnsetTimestampLinear(OnsetDataMap, Volumes[Iteration], ExcludedTimestamps, ExclusionRadius)};
+		if (Timestamp >= 0.0f)
+		{
+			ExcludedTimestamps[Iteration % ExcludedCount] = Timestamp;
+			++LinearFoundCount;
+		}
+	}
+	const double LinearTime {(FPlatformTime::Seconds() - LinearStartTime) / Iterations};
+
+	ExcludedTimestamps.Init(-1.0f, ExcludedCount);
+
+	int32 IndexFoundCount {0};
+	const double IndexStartTime {FPlatformTime::Seconds()};
+	for (int32 Iteration {0}; Iteration < Iterations; ++Iteration)
+	{
+		const int32 BestIndex {OnsetIndex.FindBestOnset(Volumes[Iteration], ExcludedTimestamps, ExclusionRadius)};
+		if (BestIndex != INDEX_NONE)
+		{
+			ExcludedTimestamps[Iteration % ExcludedCount] = OnsetIndex.GetTimestamp(BestIndex);
+			++IndexFoundCount;
+		}
+	}
+	const double IndexTime {(FPlatformTime::Seconds() - IndexStartTime) / Iterations};
+
+	UE_LOG(LogTemp, Display, TEXT("Reacoustic onset lookup for %d onsets: linear %.3f us (%d found), index %.3f us (%d found) (%.1fx)."),
+		OnsetCount, LinearTime * 1e6, LinearFoundCount, IndexTime * 1e6, IndexFoundCount, IndexTime > 0.0 ? LinearTime / IndexTime : 0.0);
+}
+
+static FAutoConsoleCommand ReacousticBenchmarkOnsetLookupCommand(
+	TEXT("Reacoustic.BenchmarkOnsetLookup"),
+	TEXT("Compares the linear onset search with the sorted onset index for sounds with 10 and 1000 onsets."),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		BenchmarkOnsetLookup(10, 100000);
+		BenchmarkOnsetLookup(1000, 10000);
+	}));
+
+void UReacousticSoundDataAsset::Serialize(FArchive& Ar)
+{
+#if WITH_EDITORONLY_DATA
+	if (Ar.IsCooking())
+	{
+		for (const FReacousticSoundData& SoundData : AudioData)
+		{
+			SoundData.GetOnsetIndex();
+		}
+	}
+#endif
+	Super::Serialize(Ar);
+}
+
+USoundWave* UReacousticSoundDataLibrary::GetImpactWave(const FReacousticSoundData& SoundData)
+{
+	return SoundData.ImpactWaveAsset.LoadSynchronous();
+}
+
+USoundWave* UReacousticSoundDataLibrary::GetSlidingWave(const FReacousticSoundData& SoundData)
+{
+	return SoundData.SlidingWaveAsset.LoadSynchronous();
+}
+
+void UReacousticSoundDataLibrary::SetImpactWave(FReacousticSoundData& SoundData, USoundWave* SoundWave)
+{
+	SoundData.ImpactWaveAsset = SoundWave;
+}
+
+void UReacousticSoundDataLibrary::SetSlidingWave(FReacousticSoundData& SoundData, USoundWave* SoundWave)
+{
+	SoundData.SlidingWaveAsset = SoundWave;
+}
@@ -0,0 +1,52 @@
+// Copyright (c) 2022-present Nino Saglia. All Rights Reserved.
+// Written by Nino Saglia.
+
+#include "ReacousticGenerateDataCommandlet.h"
+#include "ReacousticSettings.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+
+DEFINE_LOG_CATEGORY_CLASS(UReacousticGenerateDataCommandlet, LogReacousticGenerateDataCommandlet);
+
+UReacousticGenerateDataCommandlet::UReacousticGenerateDataCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UReacousticGenerateDataCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	UReacousticProjectSettings* Settings {GetMutableDefault<UReacousticProjectSettings>()};
+	if (!Settings->GenerateRuntimeData(false))
+	{
+		UE_LOG(LogReacousticGenerateDataCommandlet, Error, TEXT("Failed to generate Reacoustic runtime data."));
+		return 1;
+	}
+
+	const TArray<UObject*> GeneratedAssets {Settings->GetReacousticSoundDataAsset(), Settings->GetReacousticSoundDataRefMap()};
+	for (UObject* Asset : GeneratedAssets)
+	{
+		UPackage* Package {Asset->GetPackage()};
+		const FString Filename {FPackageName::LongPackageNameToFilename(Package->GetName(), FPackageName::GetAssetPackageExtension())};
+
+		FSavePackageArgs SaveArgs;
+		SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+		SaveArgs.SaveFlags = SAVE_NoError;
+		if (!UPackage::SavePackage(Package, Asset, *Filename, SaveArgs))
+		{
+			UE_LOG(LogReacousticGenerateDataCommandlet, Error, TEXT("Failed to save '%s'."), *Filename);
+			return 1;
+		}
+		UE_LOG(LogReacousticGenerateDataCommandlet, Display, TEXT("Saved '%s'."), *Filename);
+	}
+
+	return 0;
+#else
+	UE_LOG(LogReacousticGenerateDataCommandlet, Error, TEXT("Reacoustic runtime data can only be generated in editor builds."));
+	return 1;
+#endif
+}
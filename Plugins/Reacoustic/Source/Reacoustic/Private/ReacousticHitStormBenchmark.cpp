@@ -0,0 +1,179 @@
+// Copyright (c) 2022-present Nino Saglia. All Rights Reserved.
+// Written by Nino Saglia.
+
+#include "ReacousticHitStormBenchmark.h"
+#include "ReacousticComponent.h"
+#include "ReacousticSubsystem.h"
+#include "ReacousticAudioComponentManager.h"
+#include "Engine/StaticMeshActor.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_CLASS(UReacousticHitStormBenchmark, LogReacousticHitStormBenchmark);
+
+bool UReacousticHitStormBenchmark::Start(const int32 PropCount, const int32 InFrameCount)
+{
+	if (IsRunning())
+	{
+		UE_LOG(LogReacousticHitStormBenchmark, Warning, TEXT("A hit storm benchmark is already running."));
+		return false;
+	}
+
+	const TSubclassOf<UReacousticComponent> ComponentClass {Owner ? Owner->LoadDefaultComponentClass() : nullptr};
+	if (!ComponentClass)
+	{
+		UE_LOG(LogReacousticHitStormBenchmark, Error, TEXT("Failed to start hit storm benchmark: no Reacoustic component class is set in the project settings."));
+		return false;
+	}
+
+	const double StartTime {FPlatformTime::Seconds()};
+	SpawnProps(FMath::Max(PropCount, 1), ComponentClass);
+	PopulationTime = FPlatformTime::Seconds() - StartTime;
+
+	FrameCount = FMath::Max(InFrameCount, 1);
+	FrameRecords.Reset(FrameCount);
+	ReportPath.Reset();
+
+	UE_LOG(LogReacousticHitStormBenchmark, Display, TEXT("Started hit storm benchmark with %d props in %.2f ms. Recording %d frames."),
+		Props.Num(), PopulationTime * 1000.0, FrameCount);
+	return true;
+}
+
+void UReacousticHitStormBenchmark::Tick(const float DeltaTime)
+{
+	if (!IsRunning() || !Owner) { return; }
+
+	FFrameRecord& Record {FrameRecords.AddDefaulted_GetRef()};
+	Record.DeltaTime = DeltaTime;
+	Record.ImpactStats = Owner->GetImpactStats();
+	Record.ActiveVoices = Owner->GetAudioComponentManager() ? Owner->GetAudioComponentManager()->GetActiveVoiceCount() : 0;
+	Record.ImpactProcessTime = Owner->GetLastImpactProcessTime();
+
+	if (FrameRecords.Num() >= FrameCount)
+	{
+		Finish();
+	}
+}
+
+void UReacousticHitStormBenchmark::Finish()
+{
+	if (!IsRunning()) { return; }
+
+	for (AActor* Prop : Props)
+	{
+		if (Prop)
+		{
+			Prop->Destroy();
+		}
+	}
+	Props.Reset();
+
+	ReportPath = WriteReport();
+	FrameCount = 0;
+
+	if (FParse::Param(FCommandLine::Get(), TEXT("ReacousticExitAfterBenchmark")))
+	{
+		FPlatformMisc::RequestExit(false);
+	}
+}
+
+void UReacousticHitStormBenchmark::SpawnProps(const int32 PropCount, TSubclassOf<UReacousticComponent> ComponentClass)
+{
+	UWorld* World {Owner ? Owner->GetWorld() : nullptr};
+	UStaticMesh* Mesh {LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"))};
+	if (!World || !Mesh) { return; }
+
+	/** Build the stack in front of the listener, so that the impacts are not culled by distance. */
+	FVector Origin {FVector::ZeroVector};
+	if (Owner->GetListenerLocation(Origin))
+	{
+		Origin += FVector(500.0, 0.0, 0.0);
+	}
+
+	/** A fixed seed makes the layout of the stack identical between runs. */
+	FRandomStream RandomStream {1337};
+	constexpr double PropSize {50.0};
+	constexpr double Spacing {PropSize * 1.1};
+	const int32 Width {FMath::Max(FMath::CeilToInt(FMath::Sqrt(static_cast<float>(PropCount)) / 2.0f), 1)};
+	const int32 PropsPerLayer {Width * Width};
+
+	/** Use the sound data mapped to the cube if there is any, so that the benchmark always has sounds to play. */
+	const FReacousticSoundDataHandle FallbackSoundDataHandle {Owner->ReacousticSoundDataAsset && !Owner->ReacousticSoundDataAsset->AudioData.IsEmpty() ? 0 : INDEX_NONE};
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	Props.Reserve(PropCount);
+
+	/** The props receive their component below, so they should not be queued for population as well. */
+	Owner->SetIgnoresSpawnedActors(true);
+
+	for (int32 Index {0}; Index < PropCount; ++Index)
+	{
+		const int32 Layer {Index / PropsPerLayer};
+		const int32 Column {(Index % PropsPerLayer) % Width};
+		const int32 Row {(Index % PropsPerLayer) / Width};
+		const FVector Jitter {RandomStream.FRandRange(-0.2, 0.2) * PropSize, RandomStream.FRandRange(-0.2, 0.2) * PropSize, 0.0};
+		const FVector Location {Origin + FVector(Column * Spacing, Row * Spacing, PropSize + Layer * Spacing) + Jitter};
+		const FRotator Rotation {RandomStream.FRandRange(-10.0, 10.0), RandomStream.FRandRange(0.0, 360.0), RandomStream.FRandRange(-10.0, 10.0)};
+
+		AStaticMeshActor* Prop {World->SpawnActor<AStaticMeshActor>(Location, Rotation, SpawnParameters)};
+		if (!Prop) { continue; }
+
+		UStaticMeshComponent* MeshComponent {Prop->GetStaticMeshComponent()};
+		MeshComponent->SetMobility(EComponentMobility::Movable);
+		MeshComponent->SetStaticMesh(Mesh);
+		MeshComponent->SetWorldScale3D(FVector(PropSize / 100.0));
+		MeshComponent->SetSimulatePhysics(true);
+		MeshComponent->SetNotifyRigidBodyCollision(true);
+		Props.Add(Prop);
+
+		const FReacousticSoundDataHandle MeshSoundDataHandle {Owner->FindMeshSoundDataHandle(MeshComponent)};
+		Owner->AddReacousticComponentToActor(Prop, ComponentClass, MeshSoundDataHandle.IsValid() ? MeshSoundDataHandle : FallbackSoundDataHandle);
+	}
+
+	Owner->SetIgnoresSpawnedActors(false);
+}
+
+UReacousticHitStormBenchmark::FSummary UReacousticHitStormBenchmark::GetSummary() const
+{
+	FSummary Summary;
+	double TotalImpactProcessTime {0.0};
+
+	for (const FFrameRecord& Record : FrameRecords)
+	{
+		Summary.EventsReceived += Record.ImpactStats.EventsReceived;
+		Summary.VoicesStarted += Record.ImpactStats.VoicesStarted;
+		TotalImpactProcessTime += Record.ImpactProcessTime;
+		Summary.MaxImpactProcessTime = FMath::Max(Summary.MaxImpactProcessTime, Record.ImpactProcessTime);
+	}
+
+	Summary.AverageImpactProcessTime = FrameRecords.IsEmpty() ? 0.0 : TotalImpactProcessTime / FrameRecords.Num();
+	return Summary;
+}
+
+FString UReacousticHitStormBenchmark::WriteReport() const
+{
+	FString Report {TEXT("Frame,DeltaTimeMs,EventsReceived,EventsCulled,EventsCulledByDistance,EventsMerged,VoicesStarted,ActiveVoices,ImpactProcessMs\n")};
+
+	for (int32 Frame {0}; Frame < FrameRecords.Num(); ++Frame)
+	{
+		const FFrameRecord& Record {FrameRecords[Frame]};
+		Report += FString::Printf(TEXT("%d,%.3f,%d,%d,%d,%d,%d,%d,%.4f\n"), Frame, Record.DeltaTime * 1000.0f,
+			Record.ImpactStats.EventsReceived, Record.ImpactStats.EventsCulled, Record.ImpactStats.EventsCulledByDistance, Record.ImpactStats.EventsMerged,
+			Record.ImpactStats.VoicesStarted, Record.ActiveVoices, Record.ImpactProcessTime * 1000.0);
+	}
+
+	const FString NewReportPath {FPaths::ProjectSavedDir() / TEXT("Reacoustic") / FString::Printf(TEXT("HitStorm_%s.csv"), *FDateTime::Now().ToString())};
+	if (!FFileHelper::SaveStringToFile(Report, *NewReportPath))
+	{
+		UE_LOG(LogReacousticHitStormBenchmark, Error, TEXT("Failed to write hit storm report to '%s'."), *NewReportPath);
+		return FString();
+	}
+
+	const FSummary Summary {GetSummary()};
+	UE_LOG(LogReacousticHitStormBenchmark, Display, TEXT("Hit storm benchmark finished. Frames: %d, Population: %.2f ms, Hit events: %lld, Voices started: %lld, Impact processing: %.3f ms average, %.3f ms max."),
+		FrameRecords.Num(), PopulationTime * 1000.0, Summary.EventsReceived, Summary.VoicesStarted,
+		Summary.AverageImpactProcessTime * 1000.0, Summary.MaxImpactProcessTime * 1000.0);
+	UE_LOG(LogReacousticHitStormBenchmark, Display, TEXT("Wrote hit storm report to '%s'."), *NewReportPath);
+	return NewReportPath;
+}
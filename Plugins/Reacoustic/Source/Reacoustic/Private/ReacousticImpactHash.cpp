@@ -0,0 +1,110 @@
+// Copyright (c) 2022-present Nino Saglia. All Rights Reserved.
+// Written by Nino Saglia.
+
+#include "ReacousticImpactHash.h"
+
+void FReacousticImpactHash::Configure(const float InMergeRadius, const double InTimeWindow)
+{
+	TimeWindow = InTimeWindow;
+
+	const float NewMergeRadius {FMath::Max(InMergeRadius, 1.0f)};
+	if (NewMergeRadius == MergeRadius) { return; }
+
+	MergeRadius = NewMergeRadius;
+	InverseCellSize = 1.0 / MergeRadius;
+	Reset();
+}
+
+void FReacousticImpactHash::BeginFrame(const double Time)
+{
+	const int32 PreviousCount {Impacts.Num()};
+	Impacts.RemoveAll([Time, this](const FReacousticRecentImpact& Impact) { return Time - Impact.Time > TimeWindow; });
+
+	for (FReacousticRecentImpact& Impact : Impacts)
+	{
+		Impact.QueueIndex = INDEX_NONE;
+	}
+
+	if (Impacts.Num() == PreviousCount) { return; }
+
+	/** The window only holds a handful of impacts, so the lookups are rebuilt instead of being patched. */
+	Cells.Reset();
+	Pairs.Reset();
+
+	for (int32 Index {0}; Index < Impacts.Num(); ++Index)
+	{
+		Cells.FindOrAdd(GetCell(Impacts[Index].Location)).Add(Index);
+		Pairs.Add(Impacts[Index].PairKey, Index);
+	}
+}
+
+int32 FReacousticImpactHash::FindMatch(const uint64 PairKey, const FVector& Location) const
+{
+	if (Impacts.IsEmpty()) { return INDEX_NONE; }
+
+	const double MergeRadiusSquared {FMath::Square(MergeRadius)};
+
+	/** Both components of a colliding pair report the same impact, often from slightly different contact points.
+	 *	A pair that slid or tumbled further than the merge radius produces a separate impact. */
+	if (const int32* PairIndex {Pairs.Find(PairKey)}; PairIndex && FVector::DistSquared(Impacts[*PairIndex].Location, Location) <= MergeRadiusSquared)
+	{
+		return *PairIndex;
+	}
+
+	const FIntVector Cell {GetCell(Location)};
+	double NearestDistanceSquared {MergeRadiusSquared};
+	int32 NearestIndex {INDEX_NONE};
+
+	/** The cells are as large as the merge radius, so every impact within the radius is in one of the neighbouring cells. */
+	for (int32 X {-1}; X <= 1; ++X)
+	{
+		for (int32 Y {-1}; Y <= 1; ++Y)
+		{
+			for (int32 Z {-1}; Z <= 1; ++Z)
+			{
+				const TArray<int32, TInlineAllocator<4>>* Indices {Cells.Find(Cell + FIntVector(X, Y, Z))};
+				if (!Indices) { continue; }
+
+				for (const int32 Index : *Indices)
+				{
+					const double DistanceSquared {FVector::DistSquared(Impacts[Index].Location, Location)};
+					if (DistanceSquared <= NearestDistanceSquared)
+					{
+						NearestDistanceSquared = DistanceSquared;
+						NearestIndex = Index;
+					}
+				}
+			}
+		}
+	}
+	return NearestIndex;
+}
+
+void FReacousticImpactHash::Add(const uint64 PairKey, const FVector& Location, const double Time, const float Strength, const int32 QueueIndex)
+{
+	const int32 Index {Impacts.Add({PairKey, Location, Time, Strength, QueueIndex})};
+	Cells.FindOrAdd(GetCell(Location)).Add(Index);
+	Pairs.Add(PairKey, Index);
+}
+
+void FReacousticImpactHash::Update(const int32 Index, const double Time, const float Strength, const int32 QueueIndex)
+{
+	FReacousticRecentImpact& Impact {Impacts[Index]};
+	Impact.Time = Time;
+	Impact.Strength = Strength;
+	Impact.QueueIndex = QueueIndex;
+}
+
+void FReacousticImpactHash::Reset()
+{
+	Impacts.Reset();
+	Cells.Reset();
+	Pairs.Reset();
+}
+
+uint64 FReacousticImpactHash::MakePairKey(const UObject* A, const UObject* B)
+{
+	const uint32 IdA {A ? A->GetUniqueID() : 0};
+	const uint32 IdB {B ? B->GetUniqueID() : 0};
+	return (static_cast<uint64>(FMath::Min(IdA, IdB)) << 32) | FMath::Max(IdA, IdB);
+}
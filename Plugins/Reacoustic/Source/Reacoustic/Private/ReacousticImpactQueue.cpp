@@ -0,0 +1,105 @@
+// Copyright (c) 2022-present Nino Saglia. All Rights Reserved.
+// Written by Nino Saglia.
+
+#include "ReacousticImpactQueue.h"
+#include "ReacousticComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/VectorRegister.h"
+#include "ReacousticStats.h"
+
+void FReacousticImpactKinematics::CalculateStrengths(TArrayView<float> OutStrengths) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(Reacoustic::CalculateImpactStrengths);
+
+	const int32 Count {Num()};
+	check(OutStrengths.Num() >= Count);
+
+	/** The strength is the speed along the impulse direction: |V| * |dot(V / |V|, I / |I|)|, which simplifies to |dot(V, I)| / |I|.
+	 *	Like FVector::GetSafeNormal, vectors with a squared length below SMALL_NUMBER count as zero. */
+	const VectorRegister4Float Tolerance {VectorSetFloat1(UE_SMALL_NUMBER)};
+	const int32 VectorCount {Count & ~3};
+
+	for (int32 Index {0}; Index < VectorCount; Index += 4)
+	{
+		const VectorRegister4Float IX {VectorLoad(&ImpulseX[Index])};
+		const VectorRegister4Float IY {VectorLoad(&ImpulseY[Index])};
+		const VectorRegister4Float IZ {VectorLoad(&ImpulseZ[Index])};
+		const VectorRegister4Float VX {VectorLoad(&VelocityX[Index])};
+		const VectorRegister4Float VY {VectorLoad(&VelocityY[Index])};
+		const VectorRegister4Float VZ {VectorLoad(&VelocityZ[Index])};
+
+		const VectorRegister4Float ImpulseSizeSquared {VectorMultiplyAdd(IZ, IZ, VectorMultiplyAdd(IY, IY, VectorMultiply(IX, IX)))};
+		const VectorRegister4Float VelocitySizeSquared {VectorMultiplyAdd(VZ, VZ, VectorMultiplyAdd(VY, VY, VectorMultiply(VX, VX)))};
+		const VectorRegister4Float Dot {VectorMultiplyAdd(VZ, IZ, VectorMultiplyAdd(VY, IY, VectorMultiply(VX, IX)))};
+
+		const VectorRegister4Float IsValid {VectorBitwiseAnd(VectorCompareGE(ImpulseSizeSquared, Tolerance), VectorCompareGE(VelocitySizeSquared, Tolerance))};
+		const VectorRegister4Float Strength {VectorMultiply(VectorAbs(Dot), VectorReciprocalSqrt(VectorMax(ImpulseSizeSquared, Tolerance)))};
+		VectorStore(VectorSelect(IsValid, Strength, VectorZeroFloat()), &OutStrengths[Index]);
+	}
+
+	for (int32 Index {VectorCount}; Index < Count; ++Index)
+	{
+		OutStrengths[Index] = UReacousticComponent::CalculateImpactStrength(FVector(ImpulseX[Index], ImpulseY[Index], ImpulseZ[Index]),
+			FVector(VelocityX[Index], VelocityY[Index], VelocityZ[Index]));
+	}
+}
+
+void FReacousticImpactKinematics::CalculateStrengthsScalar(TArrayView<float> OutStrengths) const
+{
+	const int32 Count {Num()};
+	check(OutStrengths.Num() >= Count);
+
+	for (int32 Index {0}; Index < Count; ++Index)
+	{
+		OutStrengths[Index] = UReacousticComponent::CalculateImpactStrength(FVector(ImpulseX[Index], ImpulseY[Index], ImpulseZ[Index]),
+			FVector(VelocityX[Index], VelocityY[Index], VelocityZ[Index]));
+	}
+}
+
+/** Compares the vectorized impact strength calculation with the scalar calculation for a batch of random hits. */
+static void BenchmarkImpactStrengths(const int32 HitCount, const int32 Iterations)
+{
+	FRandomStream RandomStream {HitCount};
+	FReacousticImpactKinematics Kinematics;
+	for (int32 Index {0}; Index < HitCount; ++Index)
+	{
+		Kinematics.Add(RandomStream.VRand() * RandomStream.FRandRange(0.0f, 5000.0f), RandomStream.VRand() * RandomStream.FRandRange(0.0f, 1000.0f));
+	}
+
+	TArray<float> ScalarStrengths;
+	TArray<float> VectorStrengths;
+	ScalarStrengths.SetNumZeroed(HitCount);
+	VectorStrengths.SetNumZeroed(HitCount);
+
+	const double ScalarStartTime {FPlatformTime::Seconds()};
+	for (int32 Iteration {0}; Iteration < Iterations; ++Iteration)
+	{
+		Kinematics.CalculateStrengthsScalar(ScalarStrengths);
+	}
+	const double ScalarTime {(FPlatformTime::Seconds() - ScalarStartTime) / Iterations};
+
+	const double VectorStartTime {FPlatformTime::Seconds()};
+	for (int32 Iteration {0}; Iteration < Iterations; ++Iteration)
+	{
+		Kinematics.CalculateStrengths(VectorStrengths);
+	}
+	const double VectorTime {(FPlatformTime::Seconds() - VectorStartTime) / Iterations};
+
+	float MaxError {0.0f};
+	for (int32 Index {0}; Index < HitCount; ++Index)
+	{
+		MaxError = FMath::Max(MaxError, FMath::Abs(ScalarStrengths[Index] - VectorStrengths[Index]) / FMath::Max(ScalarStrengths[Index], 1.0f));
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Reacoustic impact strengths for %d hits: scalar %.2f us, vectorized %.2f us (%.1fx), max relative error %g."),
+		HitCount, ScalarTime * 1e6, VectorTime * 1e6, VectorTime > 0.0 ? ScalarTime / VectorTime : 0.0, MaxError);
+}
+
+static FAutoConsoleCommand ReacousticBenchmarkImpactStrengthsCommand(
+	TEXT("Reacoustic.BenchmarkImpactStrengths"),
+	TEXT("Compares the vectorized and scalar Reacoustic impact strength calculation for 1k and 10k hits."),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		BenchmarkImpactStrengths(1000, 1000);
+		BenchmarkImpactStrengths(10000, 100);
+	}));
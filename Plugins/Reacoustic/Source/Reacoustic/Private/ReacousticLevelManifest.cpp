@@ -0,0 +1,102 @@
+// Copyright (c) 2022-present Nino Saglia. All Rights Reserved.
+// Written by Nino Saglia.
+
+#include "ReacousticLevelManifest.h"
+#include "ReacousticSettings.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "Components/StaticMeshComponent.h"
+#include "UObject/ObjectSaveContext.h"
+
+const UReacousticLevelManifest* UReacousticLevelManifest::Find(const ULevel* Level)
+{
+	return Level ? const_cast<ULevel*>(Level)->GetAssetUserData<UReacousticLevelManifest>() : nullptr;
+}
+
+bool UReacousticLevelManifest::IsAllowedActor(const AActor* Actor, TConstArrayView<UClass*> ActorClasses)
+{
+	if (!Actor) { return false; }
+
+	for (const UClass* ActorClass : ActorClasses)
+	{
+		if (ActorClass && Actor->IsA(ActorClass))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+#if WITH_EDITOR
+bool UReacousticLevelManifest::IsCompatibleActor(const AActor* Actor)
+{
+	const UPrimitiveComponent* RootComponent {Actor ? Cast<UPrimitiveComponent>(Actor->GetRootComponent()) : nullptr};
+	if (!RootComponent || !RootComponent->BodyInstance.bSimulatePhysics) { return false; }
+
+	TArray<UStaticMeshComponent*> Components;
+	Actor->GetComponents<UStaticMeshComponent>(Components);
+	for (const UStaticMeshComponent* Component : Components)
+	{
+		if (Component->BodyInstance.bNotifyRigidBodyCollision)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void UReacousticLevelManifest::Build(ULevel* Level, TConstArrayView<UClass*> ActorClasses)
+{
+	if (!Level) { return; }
+
+	Remove(Level);
+
+	/** Actors saved in their own package cannot be referenced from the level package.
+	 *	Levels that use them do not receive a manifest, so that all of their actors are found by the runtime search instead. */
+	if (Level->IsUsingExternalActors())
+	{
+		return;
+	}
+
+	/** The manifest is only created once all actors are known to be referenceable, so that no orphaned manifest is saved into the level package. */
+	TArray<AActor*> ManifestActors;
+	for (AActor* Actor : Level->Actors)
+	{
+		if (!Actor) { continue; }
+
+		if (Actor->IsPackageExternal()) { return; }
+
+		if (IsAllowedActor(Actor, ActorClasses) && IsCompatibleActor(Actor))
+		{
+			ManifestActors.Add(Actor);
+		}
+	}
+
+	UReacousticLevelManifest* Manifest {NewObject<UReacousticLevelManifest>(Level)};
+	Manifest->Actors = MoveTemp(ManifestActors);
+	Level->AddAssetUserData(Manifest);
+}
+
+void UReacousticLevelManifest::Remove(ULevel* Level)
+{
+	if (Level && Level->GetAssetUserData<UReacousticLevelManifest>())
+	{
+		Level->RemoveUserDataOfClass(UReacousticLevelManifest::StaticClass());
+	}
+}
+
+void UReacousticLevelManifest::HandlePreSaveWorld(UWorld* World, FObjectPreSaveContext SaveContext)
+{
+	const UReacousticProjectSettings* Settings {GetDefault<UReacousticProjectSettings>()};
+	if (!World || !World->PersistentLevel || !Settings) { return; }
+
+	if (SaveContext.IsCooking() && Settings->AutoPopulateOnBeginPlay)
+	{
+		Build(World->PersistentLevel, Settings->LoadAutoPopulateActorClasses());
+	}
+	else
+	{
+		Remove(World->PersistentLevel);
+	}
+}
+#endif
@@ -0,0 +1,22 @@
+// Copyright (c) 2022-present Nino Saglia. All Rights Reserved.
+// Written by Nino Saglia.
+
+#include "ReacousticOnsetNRT.h"
+
+#if WITH_EDITOR
+void UReacousticOnsetNRT::BeginAnalysis(USoundWave* SoundWave)
+{
+	FProperty* SoundProperty {FindFProperty<FProperty>(UAudioAnalyzerNRT::StaticClass(), GET_MEMBER_NAME_CHECKED(UAudioAnalyzerNRT, Sound))};
+
+	/** Assigning the sound directly does not analyse it. The analysis is started by the property change notification. */
+	PreEditChange(SoundProperty);
+	Sound = SoundWave;
+	FPropertyChangedEvent PropertyChangedEvent(SoundProperty, EPropertyChangeType::ValueSet);
+	PostEditChangeProperty(PropertyChangedEvent);
+}
+#endif
+
+bool UReacousticOnsetNRT::HasResult() const
+{
+	return GetResult<Audio::IAnalyzerNRTResult>().IsValid();
+}
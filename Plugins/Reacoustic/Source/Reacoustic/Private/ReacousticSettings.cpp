@@ -5,24 +5,85 @@
 #include "ReacousticSubsystem.h"
 #include "Reacoustic.h"
 #include "AudioAnalyzerNRT.h"
-#include "OnsetNRT.h"
+#include "ReacousticOnsetNRT.h"
 #include "Engine/DataTable.h"
+#include "Misc/ScopedSlowTask.h"
+#include "UObject/StrongObjectPtr.h"
 #include "Evaluation/Blending/MovieSceneBlendType.h"
 #include "Serialization/JsonTypes.h"
+#include "Engine/StaticMeshActor.h"
 
 UReacousticProjectSettings::UReacousticProjectSettings(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
 }
 
+TArray<UClass*> UReacousticProjectSettings::LoadAutoPopulateActorClasses() const
+{
+	TArray<UClass*> ActorClasses;
+	for (const TSoftClassPtr<AActor>& ActorClass : AutoPopulateActorClasses)
+	{
+		if (UClass* LoadedClass {ActorClass.LoadSynchronous()})
+		{
+			ActorClasses.AddUnique(LoadedClass);
+		}
+	}
+
+	if (ActorClasses.IsEmpty())
+	{
+		ActorClasses.Add(AStaticMeshActor::StaticClass());
+	}
+	return ActorClasses;
+}
+
+TArray<UClass*> UReacousticProjectSettings::LoadHitNotificationOwnerComponentClasses() const
+{
+	TArray<UClass*> ComponentClasses;
+	for (const TSoftClassPtr<UActorComponent>& ComponentClass : HitNotificationOwnerComponentClasses)
+	{
+		if (UClass* LoadedClass {ComponentClass.LoadSynchronous()})
+		{
+			ComponentClasses.AddUnique(LoadedClass);
+		}
+	}
+	return ComponentClasses;
+}
+
 #if WITH_EDITOR
-void UReacousticProjectSettings::GenerateRuntimeData()
+#define LOCTEXT_NAMESPACE "ReacousticSettings"
+
+/** A data table row that is converted into sound data by GenerateRuntimeData. */
+struct FReacousticGeneratedRow
 {
-	//TODO: Create the assets
-	if (ReacousticSoundDataAsset){}
-	if (ReacousticSoundDataRefMap){}
+	FReacousticSoundData SoundData;
+
+	/** The meshes that use this sound data. Only used by object rows. */
+	TArray<UStaticMesh*> Meshes;
+
+	/** The surface that uses this sound data. Only set for surface rows. */
+	TOptional<EPhysicalSurface> SurfaceType;
+};
+
+bool UReacousticProjectSettings::GenerateRuntimeData(const bool CanCancel)
+{
+	const double StartTime {FPlatformTime::Seconds()};
+
+	ReacousticSoundDataAsset = Cast<UReacousticSoundDataAsset>(GeneratedSoundDataAsset.TryLoad());
+	ReacousticSoundDataRefMap = Cast<UReacousticSoundDataRef_Map>(GeneratedSoundDataRefMap.TryLoad());
+	if (!ReacousticSoundDataAsset || !ReacousticSoundDataRefMap)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Failed to generate Reacoustic runtime data: the generated sound data asset or reference map could not be loaded."));
+		return false;
+	}
+
+	/** Seed the cache before the asset is regenerated, so that the onsets of unchanged sounds are reused. */
+	SeedOnsetAnalysisCache();
+
 	UDataTable* Objects = Cast<UDataTable>(ReacousticObjects.TryLoad());
 	UDataTable* Surfaces = Cast<UDataTable>(ReacousticSurfaces.TryLoad());
+
+	TArray<FReacousticGeneratedRow> Rows;
+
 	if (Objects)
 	{
 		/** Check that the RowStruct type is correct */
@@ -30,40 +91,20 @@ void UReacousticProjectSettings::GenerateRuntimeData()
 		{
 			for (auto& Row : Objects->GetRowMap())
 			{
-				FName RowName = Row.Key;
-
-				FReacousticObjects* RowData = Objects->FindRow<FReacousticObjects>(RowName, TEXT("ContextString"));
+				FReacousticObjects* RowData = Objects->FindRow<FReacousticObjects>(Row.Key, TEXT("ContextString"));
 
 				if(RowData)
 				{
-					/** Create FReacousticSoundData from the RowData and add it to your asset */
-					FReacousticSoundData NewData;
-					NewData.Gain = RowData->Gain_Db;
-					NewData.ImpulseLength = RowData->ImpulseLength;
-					NewData.ImpactWaveAsset = RowData->HitSound.Get();
-					NewData.MaxSpeedScalar = RowData->MaxSpeedScalar;
-
-					//TODO: create an onset nrt and delete it later.
-					UOnsetNRT* OnsetNRT = NewObject<UOnsetNRT>();
-
-					
-					OnsetNRT->Sound = RowData->HitSound.Get();
-					
-					TArray<float> OutOnsetTimestamps;
-					TArray<float> OutOnsetStrengths;
-					/**Retreive the onset data.*/
-					OnsetNRT->GetNormalizedChannelOnsetsBetweenTimes(0.0,RowData->HitSound->Duration,2,OutOnsetTimestamps,OutOnsetStrengths);
-					
-					int NewIndex = ReacousticSoundDataAsset->AudioData.Add(NewData);
-
-					/** Now create entries in UReacousticSoundDataRef_Map for each static mesh */
-					for (auto& Mesh : RowData->Meshes)
-					{
-						FMeshToAudioMapEntry NewEntry;
-						NewEntry.Mesh = Mesh;
-						NewEntry.ReacousticSoundDataRef = NewIndex;
-						ReacousticSoundDataRefMap->MeshMapEntries.Add(NewEntry);
-					}
+					/** Create FReacousticSoundData from the RowData. */
+					FReacousticGeneratedRow& NewRow {Rows.AddDefaulted_GetRef()};
+					NewRow.SoundData.Gain = RowData->Gain_Db;
+					NewRow.SoundData.ImpulseLength = RowData->ImpulseLength;
+					NewRow.SoundData.ImpactWaveAsset = RowData->HitSound.Get();
+					NewRow.SoundData.SlidingWaveAsset = RowData->SlidingRollingSound.Get();
+					NewRow.SoundData.MaxSpeedScalar = RowData->MaxSpeedScalar;
+					NewRow.SoundData.Attenuation = RowData->Sound_Attenuation.Get();
+					NewRow.SoundData.Concurrency = RowData->Sound_Concurrency.Get();
+					NewRow.Meshes = RowData->Meshes;
 				}
 			}
 		}
@@ -72,12 +113,281 @@ void UReacousticProjectSettings::GenerateRuntimeData()
 			UE_LOG(LogTemp, Error, TEXT("DataTable has incorrect RowStruct type"));
 		}
 	}
+
+	if (Surfaces)
+	{
+		if (Surfaces->RowStruct->IsChildOf(FReacousticSurfaces::StaticStruct()))
+		{
+			for (auto& Row : Surfaces->GetRowMap())
+			{
+				FReacousticSurfaces* RowData = Surfaces->FindRow<FReacousticSurfaces>(Row.Key, TEXT("ContextString"));
+
+				if (RowData)
+				{
+					FReacousticGeneratedRow& NewRow {Rows.AddDefaulted_GetRef()};
+					NewRow.SoundData.Gain = RowData->Gain_Db;
+					NewRow.SoundData.ImpulseLength = RowData->ImpulseLength;
+					NewRow.SoundData.ImpactWaveAsset = RowData->HitSound.Get();
+					NewRow.SoundData.SlidingWaveAsset = RowData->SlidingRollingSound.Get();
+					NewRow.SoundData.MaxSpeedScalar = RowData->MaxSpeedScalar;
+					NewRow.SoundData.SurfaceDampeningPercentage = RowData->SurfaceDampeningPercentage;
+					NewRow.SurfaceType = RowData->Material.GetValue();
+				}
+			}
+		}
+		else
+		{
+			UE_LOG(LogTemp, Error, TEXT("DataTable has incorrect RowStruct type"));
+		}
+	}
+
+	/** Collect the unique sounds that are not in the cache. Rows that share a sound are only analysed once. */
+	TArray<USoundWave*> PendingSounds;
+	TArray<uint32> PendingHashes;
+	TSet<uint32> PendingHashSet;
+	for (const FReacousticGeneratedRow& Row : Rows)
+	{
+		const uint32 AnalysisHash {GetOnsetAnalysisHash(Row.SoundData.ImpactWaveAsset.Get())};
+		if (AnalysisHash == 0 || OnsetAnalysisCache.Contains(AnalysisHash) || PendingHashSet.Contains(AnalysisHash))
+		{
+			continue;
+		}
+		PendingHashSet.Add(AnalysisHash);
+		PendingHashes.Add(AnalysisHash);
+		PendingSounds.Add(Row.SoundData.ImpactWaveAsset.Get());
+	}
+
+	/** Every pending sound gets its own analyzer and output slot, so that all sounds of a batch can be analysed at the same time. */
+	TArray<FReacousticOnsetAnalysis> PendingResults;
+	PendingResults.SetNum(PendingSounds.Num());
+	TArray<bool> PendingSucceeded;
+	PendingSucceeded.Init(false, PendingSounds.Num());
+
+	TArray<TStrongObjectPtr<UReacousticOnsetNRT>> Analyzers;
+	Analyzers.Reserve(PendingSounds.Num());
+	for (int32 Index {0}; Index < PendingSounds.Num(); ++Index)
+	{
+		Analyzers.Emplace(NewObject<UReacousticOnsetNRT>(GetTransientPackage()));
+	}
+
+	/** Analyse in batches, so that progress can be reported and cancellation can be checked in between. */
+	FScopedSlowTask SlowTask(static_cast<float>(PendingSounds.Num()), LOCTEXT("GenerateRuntimeData", "Generating Reacoustic runtime data"));
+	SlowTask.MakeDialog(CanCancel);
+
+	const int32 BatchSize {FMath::Max(FTaskGraphInterface::Get().GetNumWorkerThreads(), 1) * 2};
+	int32 AnalysedCount {0};
+	bool IsCancelled {false};
+
+	while (AnalysedCount < PendingSounds.Num())
+	{
+		if (CanCancel && SlowTask.ShouldCancel())
+		{
+			IsCancelled = true;
+			break;
+		}
+
+		const int32 BatchStart {AnalysedCount};
+		const int32 BatchCount {FMath::Min(BatchSize, PendingSounds.Num() - BatchStart)};
+		SlowTask.EnterProgressFrame(static_cast<float>(BatchCount), FText::Format(LOCTEXT("AnalysingOnsets", "Analysing onsets ({0}/{1})"),
+			BatchStart + BatchCount, PendingSounds.Num()));
+
+		/** The analyses are started on the game thread, as they modify the analyzers. Each analysis then runs on its own background task. */
+		for (int32 Index {BatchStart}; Index < BatchStart + BatchCount; ++Index)
+		{
+			if (PendingSounds[Index])
+			{
+				Analyzers[Index]->BeginAnalysis(PendingSounds[Index]);
+			}
+		}
+
+		WaitForOnsetAnalyses(TArrayView<const TStrongObjectPtr<UReacousticOnsetNRT>>(Analyzers).Slice(BatchStart, BatchCount));
+
+		for (int32 Index {BatchStart}; Index < BatchStart + BatchCount; ++Index)
+		{
+			PendingSucceeded[Index] = ReadOnsetAnalysis(Analyzers[Index].Get(), PendingSounds[Index], PendingResults[Index]);
+		}
+
+		AnalysedCount += BatchCount;
+	}
+
+	/** Completed results are always cached, so that a cancelled generation resumes where it left off.
+	 *	Failed or empty analyses are not cached, so that they are retried by the next generation. */
+	for (int32 Index {0}; Index < AnalysedCount; ++Index)
+	{
+		if (PendingSucceeded[Index])
+		{
+			OnsetAnalysisCache.Add(PendingHashes[Index], MoveTemp(PendingResults[Index]));
+		}
+	}
+
+	if (IsCancelled)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Generating Reacoustic runtime data was cancelled. Analysed sounds: '%d' of '%d'"), AnalysedCount, PendingSounds.Num());
+		return false;
+	}
+
+	/** Merge all rows into the generated assets in table order, so that the output does not depend on the order in which the analysis finished. */
+	ReacousticSoundDataAsset->AudioData.Reset(Rows.Num());
+	ReacousticSoundDataRefMap->MeshMapEntries.Reset();
+	ReacousticSoundDataRefMap->PhysicalMaterialMapEntries.Reset();
+
+	for (FReacousticGeneratedRow& Row : Rows)
+	{
+		const uint32 AnalysisHash {GetOnsetAnalysisHash(Row.SoundData.ImpactWaveAsset.Get())};
+		if (const FReacousticOnsetAnalysis* Analysis {OnsetAnalysisCache.Find(AnalysisHash)})
+		{
+			ApplyOnsetAnalysis(*Analysis, AnalysisHash, Row.SoundData);
+		}
+
+		const int32 NewIndex {ReacousticSoundDataAsset->AudioData.Add(MoveTemp(Row.SoundData))};
+
+		/** Now create entries in UReacousticSoundDataRef_Map for each static mesh */
+		for (UStaticMesh* Mesh : Row.Meshes)
+		{
+			FMeshToAudioMapEntry NewEntry;
+			NewEntry.Mesh = Mesh;
+			NewEntry.ReacousticSoundDataRef = NewIndex;
+			ReacousticSoundDataRefMap->MeshMapEntries.Add(NewEntry);
+		}
+
+		if (Row.SurfaceType.IsSet())
+		{
+			FPhysicalMaterialToAudioMapEntry NewEntry;
+			NewEntry.SurfaceType = Row.SurfaceType.GetValue();
+			NewEntry.ReacousticSoundDataRef = NewIndex;
+			ReacousticSoundDataRefMap->PhysicalMaterialMapEntries.Add(NewEntry);
+		}
+	}
+
+	ReacousticSoundDataAsset->MarkPackageDirty();
+	ReacousticSoundDataRefMap->MarkPackageDirty();
+
+	UE_LOG(LogTemp, Log, TEXT("Generated Reacoustic runtime data in %.2f ms. Rows: '%d', Analysed sounds: '%d'"),
+		(FPlatformTime::Seconds() - StartTime) * 1000.0, Rows.Num(), AnalysedCount);
+	return true;
+}
+
+uint32 UReacousticProjectSettings::GetOnsetAnalysisHash(const USoundWave* SoundWave)
+{
+	if (!SoundWave) { return 0; }
+
+	uint32 Hash {GetTypeHash(SoundWave->CompressedDataGuid)};
+	Hash = HashCombine(Hash, GetTypeHash(SoundWave->Duration));
+	Hash = HashCombine(Hash, GetTypeHash(SoundWave->NumChannels));
+	Hash = HashCombine(Hash, GetTypeHash(OnsetAnalysisChannel));
+	Hash = HashCombine(Hash, GetTypeHash(OnsetAnalysisVersion));
+
+	/** Zero is reserved for sound data without onset analysis. */
+	return Hash != 0 ? Hash : 1;
+}
+
+bool UReacousticProjectSettings::GenerateReacousticRuntimeData()
+{
+	return GetMutableDefault<UReacousticProjectSettings>()->GenerateRuntimeData();
+}
+
+void UReacousticProjectSettings::GetSoundDataOnsets(const FReacousticSoundData& SoundData, TArray<float>& OnsetTimingData, TArray<float>& OnsetVolumeData, TMap<float, float>& OnsetDataMap)
+{
+	OnsetTimingData = SoundData.OnsetTimingData;
+	OnsetVolumeData = SoundData.OnsetVolumeData;
+	OnsetDataMap = SoundData.OnsetDataMap;
+}
+
+void UReacousticProjectSettings::SetSoundDataOnsets(FReacousticSoundData& SoundData, const TArray<float>& OnsetTimingData, const TArray<float>& OnsetVolumeData)
+{
+	FReacousticOnsetAnalysis Analysis;
+	Analysis.Timestamps = OnsetTimingData;
+	Analysis.Strengths = OnsetVolumeData;
+	ApplyOnsetAnalysis(Analysis, 0, SoundData);
+}
+
+void UReacousticProjectSettings::WaitForOnsetAnalyses(TArrayView<const TStrongObjectPtr<UReacousticOnsetNRT>> OnsetNRTs)
+{
+	const auto IsFinished = [OnsetNRTs]()
+	{
+		for (const TStrongObjectPtr<UReacousticOnsetNRT>& OnsetNRT : OnsetNRTs)
+		{
+			if (OnsetNRT.IsValid() && OnsetNRT->Sound && !OnsetNRT->HasResult()) { return false; }
+		}
+		return true;
+	};
+
+	/** The results are set by tasks on the game thread, so the game thread is pumped until every result has arrived. */
+	const double TimeoutTime {FPlatformTime::Seconds() + OnsetAnalysisTimeout};
+	while (!IsFinished() && FPlatformTime::Seconds() < TimeoutTime)
+	{
+		FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+		FPlatformProcess::Sleep(0.001f);
+	}
+}
+
+bool UReacousticProjectSettings::ReadOnsetAnalysis(const UReacousticOnsetNRT* OnsetNRT, const USoundWave* SoundWave, FReacousticOnsetAnalysis& OutAnalysis)
+{
+	if (!OnsetNRT || !SoundWave) { return false; }
+
+	if (!OnsetNRT->HasResult())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Onset analysis of '%s' did not finish within %.0f seconds."), *SoundWave->GetName(), OnsetAnalysisTimeout);
+		return false;
+	}
+
+	/**Retreive the onset data.*/
+	OnsetNRT->GetNormalizedChannelOnsetsBetweenTimes(0.0f, SoundWave->Duration, OnsetAnalysisChannel, OutAnalysis.Timestamps, OutAnalysis.Strengths);
+	return !OutAnalysis.Timestamps.IsEmpty();
+}
+
+void UReacousticProjectSettings::ApplyOnsetAnalysis(const FReacousticOnsetAnalysis& Analysis, const uint32 AnalysisHash, FReacousticSoundData& SoundData)
+{
+	SoundData.OnsetTimingData = Analysis.Timestamps;
+	SoundData.OnsetVolumeData = Analysis.Strengths;
+
+	/** Only stamp the hash when the analysis produced onsets, so that empty results are never seeded into the cache. */
+	SoundData.OnsetAnalysisHash = Analysis.Timestamps.IsEmpty() ? 0 : AnalysisHash;
+
+	const int32 OnsetCount {FMath::Min(Analysis.Timestamps.Num(), Analysis.Strengths.Num())};
+	SoundData.OnsetDataMap.Empty(OnsetCount);
+	for (int32 Index {0}; Index < OnsetCount; ++Index)
+	{
+		SoundData.OnsetDataMap.Add(Analysis.Timestamps[Index], Analysis.Strengths[Index]);
+	}
+	SoundData.OnsetIndex.Build(SoundData.OnsetDataMap);
+}
+
+void UReacousticProjectSettings::SeedOnsetAnalysisCache()
+{
+	if (!ReacousticSoundDataAsset) { return; }
+
+	for (const FReacousticSoundData& SoundData : ReacousticSoundDataAsset->AudioData)
+	{
+		/** Only seed entries that were generated with the current wave content and analysis settings. */
+		if (SoundData.OnsetAnalysisHash == 0 || SoundData.OnsetAnalysisHash != GetOnsetAnalysisHash(SoundData.ImpactWaveAsset.LoadSynchronous()))
+		{
+			continue;
+		}
+
+		if (SoundData.OnsetTimingData.IsEmpty()) { continue; }
+
+		if (!OnsetAnalysisCache.Contains(SoundData.OnsetAnalysisHash))
+		{
+			FReacousticOnsetAnalysis& Analysis {OnsetAnalysisCache.Add(SoundData.OnsetAnalysisHash)};
+			Analysis.Timestamps = SoundData.OnsetTimingData;
+			Analysis.Strengths = SoundData.OnsetVolumeData;
+		}
+	}
 }
 
 void UReacousticProjectSettings::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
 {
 	Super::PostEditChangeProperty(PropertyChangedEvent);
-	GenerateRuntimeData();
+
+	/** Only the data tables affect the generated data. Regenerating is slow and dirties the generated packages, so other settings are ignored. */
+	const FName PropertyName {PropertyChangedEvent.GetMemberPropertyName()};
+	if (PropertyName == GET_MEMBER_NAME_CHECKED(UReacousticProjectSettings, ReacousticObjects)
+		|| PropertyName == GET_MEMBER_NAME_CHECKED(UReacousticProjectSettings, ReacousticSurfaces))
+	{
+		GenerateRuntimeData();
+	}
 }
 
-#endif
\ No newline at end of file
+#undef LOCTEXT_NAMESPACE
+#endif
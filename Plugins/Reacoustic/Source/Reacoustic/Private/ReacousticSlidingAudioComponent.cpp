@@ -2,31 +2,153 @@
 // Written by Tim Verberne.
 
 #include "ReacousticSlidingAudioComponent.h"
+#include "ReacousticComponent.h"
+#include "ReacousticSlidingAudioManager.h"
+#include "ReacousticSubsystem.h"
+#include "ReacousticSoundStreamingManager.h"
+#include "Components/AudioComponent.h"
 
+DEFINE_LOG_CATEGORY_CLASS(UReacousticSlidingAudioComponent, LogReacousticSlidingAudioComponent);
 
 UReacousticSlidingAudioComponent::UReacousticSlidingAudioComponent()
 {
-	PrimaryComponentTick.bCanEverTick = true;
-	PrimaryComponentTick.bStartWithTickEnabled = false;
-	
+	PrimaryComponentTick.bCanEverTick = false;
 }
 
-
-// Called when the game starts
 void UReacousticSlidingAudioComponent::BeginPlay()
 {
 	Super::BeginPlay();
 
-	// ...
-	
+	if (const AActor* Owner {GetOwner()})
+	{
+		TArray<UStaticMeshComponent*> Components;
+		Owner->GetComponents<UStaticMeshComponent>(Components);
+		for (UStaticMeshComponent* StaticMeshComponent : Components)
+		{
+			if (StaticMeshComponent && StaticMeshComponent->IsSimulatingPhysics())
+			{
+				MeshComponent = StaticMeshComponent;
+				break;
+			}
+		}
+	}
+
+	if (!MeshComponent)
+	{
+		UE_LOG(LogReacousticSlidingAudioComponent, Warning, TEXT("%s was unable to find a static mesh component with physics simulation enabled in its owner."), *GetNameSafe(GetOwner()));
+		return;
+	}
+
+	MeshComponent->OnComponentHit.AddDynamic(this, &UReacousticSlidingAudioComponent::HandleMeshHit);
+	MeshComponent->OnComponentSleep.AddDynamic(this, &UReacousticSlidingAudioComponent::HandleMeshSleep);
+	MeshComponent->BodyInstance.bGenerateWakeEvents = true;
+
+	const UWorld* World {GetWorld()};
+	const UReacousticSubsystem* Subsystem {World ? World->GetSubsystem<UReacousticSubsystem>() : nullptr};
+	SlidingAudioManager = Subsystem ? Subsystem->GetSlidingAudioManager() : nullptr;
+	if (SlidingAudioManager)
+	{
+		SlidingAudioManager->RegisterSlidingComponent(this);
+	}
+	else
+	{
+		UE_LOG(LogReacousticSlidingAudioComponent, Warning, TEXT("%s was unable to register itself to the Reacoustic sliding audio manager."), *GetName());
+	}
 }
 
+void UReacousticSlidingAudioComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (SlidingAudioManager)
+	{
+		SlidingAudioManager->UnregisterSlidingComponent(this);
+		SlidingAudioManager = nullptr;
+	}
+	Super::EndPlay(EndPlayReason);
+}
 
-// Called every frame
-void UReacousticSlidingAudioComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+bool UReacousticSlidingAudioComponent::GetSlidingSpeed(const double CurrentTime, float& OutSpeed) const
 {
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	OutSpeed = 0.0f;
+	if (!MeshComponent || LatestContactTime < 0.0 || CurrentTime - LatestContactTime > ContactTimeout) { return false; }
+	if (!MeshComponent->IsAnyRigidBodyAwake()) { return false; }
 
-	// ...
+	/** Only the velocity along the contact surface contributes to sliding and rolling. */
+	FVector RelativeVelocity {MeshComponent->GetPhysicsLinearVelocity()};
+	if (const AActor* OtherActor {ContactActor.Get()})
+	{
+		RelativeVelocity -= OtherActor->GetVelocity();
+	}
+	const FVector TangentialVelocity {FVector::VectorPlaneProject(RelativeVelocity, ContactNormal)};
+
+	OutSpeed = TangentialVelocity.Length();
+	return OutSpeed >= MinimumSlidingSpeed;
 }
 
+USoundBase* UReacousticSlidingAudioComponent::GetSlidingSound() const
+{
+	if (SlidingSound) { return SlidingSound; }
+
+	const AActor* Owner {GetOwner()};
+	const UReacousticComponent* ReacousticComponent {Owner ? Owner->FindComponentByClass<UReacousticComponent>() : nullptr};
+	const FReacousticSoundData* SoundData {ReacousticComponent ? ReacousticComponent->GetSoundData() : nullptr};
+	if (!SoundData) { return nullptr; }
+
+	/** The loop is skipped while the wave is still streaming in. */
+	const UWorld* World {GetWorld()};
+	const UReacousticSubsystem* Subsystem {World ? World->GetSubsystem<UReacousticSubsystem>() : nullptr};
+	UReacousticSoundStreamingManager* SoundStreamingManager {Subsystem ? Subsystem->GetSoundStreamingManager() : nullptr};
+	return SoundStreamingManager ? SoundStreamingManager->RequestWave(SoundData->SlidingWaveAsset) : SoundData->SlidingWaveAsset.Get();
+}
+
+void UReacousticSlidingAudioComponent::StartLoop(UAudioComponent* AudioComponent, const float SlidingSpeed)
+{
+	if (!AudioComponent || !MeshComponent) { return; }
+
+	LoopAudioComponent = AudioComponent;
+	LoopAudioComponent->AttachToComponent(MeshComponent, FAttachmentTransformRules::SnapToTargetNotIncludingScale);
+	LoopAudioComponent->SetSound(GetSlidingSound());
+	UpdateLoop(SlidingSpeed);
+	LoopAudioComponent->Play();
+}
+
+void UReacousticSlidingAudioComponent::UpdateLoop(const float SlidingSpeed)
+{
+	if (!LoopAudioComponent) { return; }
+
+	const float Alpha {static_cast<float>(FMath::GetRangePct(MinimumSlidingSpeed, FMath::Max(MaximumSlidingSpeed, MinimumSlidingSpeed + 1.0f), SlidingSpeed))};
+	const float ClampedAlpha {FMath::Clamp(Alpha, 0.0f, 1.0f)};
+	LoopAudioComponent->SetVolumeMultiplier(FMath::Lerp(VolumeRange.X, VolumeRange.Y, ClampedAlpha));
+	LoopAudioComponent->SetPitchMultiplier(FMath::Lerp(PitchRange.X, PitchRange.Y, ClampedAlpha));
+}
+
+UAudioComponent* UReacousticSlidingAudioComponent::StopLoop()
+{
+	UAudioComponent* AudioComponent {LoopAudioComponent};
+	LoopAudioComponent = nullptr;
+	if (AudioComponent)
+	{
+		AudioComponent->Stop();
+		AudioComponent->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
+	}
+	return AudioComponent;
+}
+
+void UReacousticSlidingAudioComponent::HandleMeshHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
+{
+	const UWorld* World {GetWorld()};
+	if (!World) { return; }
+
+	LatestContactTime = World->GetTimeSeconds();
+	ContactActor = OtherActor;
+	ContactNormal = Hit.ImpactNormal.IsNearlyZero() ? FVector::UpVector : FVector(Hit.ImpactNormal);
+}
+
+void UReacousticSlidingAudioComponent::HandleMeshSleep(UPrimitiveComponent* SleepingComponent, FName BoneName)
+{
+	LatestContactTime = -1.0;
+	ContactActor.Reset();
+	if (SlidingAudioManager)
+	{
+		SlidingAudioManager->ReleaseLoop(this);
+	}
+}
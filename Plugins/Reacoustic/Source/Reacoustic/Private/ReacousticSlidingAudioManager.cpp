@@ -0,0 +1,153 @@
+// Copyright (c) 2022-present Nino Saglia. All Rights Reserved.
+// Written by Tim Verberne.
+
+#include "ReacousticSlidingAudioManager.h"
+#include "ReacousticSlidingAudioComponent.h"
+#include "ReacousticSubsystem.h"
+#include "Components/AudioComponent.h"
+#include "ReacousticStats.h"
+
+DEFINE_LOG_CATEGORY_CLASS(UReacousticSlidingAudioManager, LogReacousticSlidingAudioManager);
+
+void UReacousticSlidingAudioManager::Initialize(UReacousticSubsystem* Subsystem)
+{
+	Super::Initialize(Subsystem);
+
+	UWorld* World {Subsystem ? Subsystem->GetWorld() : nullptr};
+	if (!World)
+	{
+		UE_LOG(LogReacousticSlidingAudioManager, Warning, TEXT("Failed to initialize ReacousticSlidingAudioManager: no valid world."));
+		return;
+	}
+
+	MaxLoops = Subsystem->Settings ? FMath::Max(Subsystem->Settings->MaxSlidingLoops, 0) : 8;
+	UpdateInterval = 1.0f / (Subsystem->Settings ? FMath::Max(Subsystem->Settings->SlidingUpdateRate, 1.0f) : 30.0f);
+	AvailableLoops.Reserve(MaxLoops);
+
+	for (int32 i {0}; i < MaxLoops; ++i)
+	{
+		if (UAudioComponent* NewAudioComponent {NewObject<UAudioComponent>(Owner)})
+		{
+			NewAudioComponent->bAutoActivate = false;
+			NewAudioComponent->bAutoDestroy = false;
+			NewAudioComponent->bAllowSpatialization = true;
+			NewAudioComponent->RegisterComponentWithWorld(World);
+			AvailableLoops.Add(NewAudioComponent);
+		}
+	}
+
+	/** Loops that failed to be created are not counted, so that GetActiveLoopCount stays correct. */
+	MaxLoops = AvailableLoops.Num();
+}
+
+void UReacousticSlidingAudioManager::Deinitialize(UReacousticSubsystem* Subsystem)
+{
+	for (UReacousticSlidingAudioComponent* Component : SlidingComponents)
+	{
+		ReleaseLoop(Component);
+	}
+	SlidingComponents.Empty();
+
+	for (UAudioComponent* AudioComponent : AvailableLoops)
+	{
+		if (AudioComponent)
+		{
+			AudioComponent->Stop();
+			AudioComponent->DestroyComponent();
+		}
+	}
+	AvailableLoops.Empty();
+
+	Super::Deinitialize(Subsystem);
+}
+
+void UReacousticSlidingAudioManager::Tick(const float DeltaTime)
+{
+	if (SlidingComponents.IsEmpty()) { return; }
+
+	TimeSinceUpdate += DeltaTime;
+	if (TimeSinceUpdate < UpdateInterval) { return; }
+
+	TimeSinceUpdate = FMath::Fmod(TimeSinceUpdate, UpdateInterval);
+	UpdateSlidingComponents();
+}
+
+void UReacousticSlidingAudioManager::RegisterSlidingComponent(UReacousticSlidingAudioComponent* Component)
+{
+	if (Component)
+	{
+		SlidingComponents.AddUnique(Component);
+	}
+}
+
+void UReacousticSlidingAudioManager::UnregisterSlidingComponent(UReacousticSlidingAudioComponent* Component)
+{
+	ReleaseLoop(Component);
+	SlidingComponents.RemoveSwap(Component);
+}
+
+void UReacousticSlidingAudioManager::ReleaseLoop(UReacousticSlidingAudioComponent* Component)
+{
+	if (!Component || !Component->IsPlayingLoop()) { return; }
+
+	if (UAudioComponent* AudioComponent {Component->StopLoop()})
+	{
+		AvailableLoops.Add(AudioComponent);
+	}
+}
+
+void UReacousticSlidingAudioManager::UpdateSlidingComponents()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(Reacoustic::UpdateSlidingComponents);
+	SCOPE_CYCLE_COUNTER(STAT_ReacousticUpdateSlidingLoops);
+
+	const UWorld* World {GetOwner() ? GetOwner()->GetWorld() : nullptr};
+	if (!World) { return; }
+
+	const double CurrentTime {World->GetTimeSeconds()};
+	FVector ListenerLocation;
+	const bool HasListener {GetOwner()->GetListenerLocation(ListenerLocation)};
+
+	/** Collect the components that are sliding, and stop the loops of the components that are not. */
+	Candidates.Reset();
+	for (UReacousticSlidingAudioComponent* Component : SlidingComponents)
+	{
+		float SlidingSpeed;
+		if (!Component || !Component->GetSlidingSpeed(CurrentTime, SlidingSpeed))
+		{
+			ReleaseLoop(Component);
+			continue;
+		}
+
+		float Priority {SlidingSpeed};
+		if (HasListener && Component->GetMeshComponent())
+		{
+			const float DistanceInMeters {static_cast<float>(FVector::Distance(ListenerLocation, Component->GetMeshComponent()->GetComponentLocation())) / 100.0f};
+			Priority /= FMath::Max(DistanceInMeters, 1.0f);
+		}
+		Candidates.Add({Component, SlidingSpeed, Priority});
+	}
+
+	/** Only the components with the highest priority are heard. Loops of the other components are released first, so that they can be reused. */
+	Candidates.Sort([](const FSlidingCandidate& A, const FSlidingCandidate& B) { return A.Priority > B.Priority; });
+	for (int32 Index {MaxLoops}; Index < Candidates.Num(); ++Index)
+	{
+		ReleaseLoop(Candidates[Index].Component);
+	}
+
+	const int32 AudibleCount {FMath::Min(MaxLoops, Candidates.Num())};
+	for (int32 Index {0}; Index < AudibleCount; ++Index)
+	{
+		const FSlidingCandidate& Candidate {Candidates[Index]};
+		if (Candidate.Component->IsPlayingLoop())
+		{
+			Candidate.Component->UpdateLoop(Candidate.SlidingSpeed);
+		}
+		else if (!AvailableLoops.IsEmpty() && Candidate.Component->GetSlidingSound())
+		{
+			Candidate.Component->StartLoop(AvailableLoops.Pop(false), Candidate.SlidingSpeed);
+		}
+	}
+
+	SET_DWORD_STAT(STAT_ReacousticActiveSlidingLoops, GetActiveLoopCount());
+}
@@ -0,0 +1,138 @@
+// Copyright (c) 2022-present Nino Saglia. All Rights Reserved.
+// Written by Tim Verberne.
+
+#include "ReacousticSoundStreamingManager.h"
+#include "ReacousticSubsystem.h"
+#include "ReacousticComponent.h"
+#include "ReacousticDataTypes.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "ReacousticStats.h"
+
+DEFINE_LOG_CATEGORY_CLASS(UReacousticSoundStreamingManager, LogReacousticSoundStreamingManager);
+
+void UReacousticSoundStreamingManager::Initialize(UReacousticSubsystem* Subsystem)
+{
+	Super::Initialize(Subsystem);
+
+	if (const UReacousticProjectSettings* Settings {Subsystem ? Subsystem->Settings : nullptr})
+	{
+		UseStreaming = Settings->UseSoundStreaming;
+		PrefetchRadius = Settings->SoundPrefetchRadius;
+		ReleaseDelay = Settings->SoundReleaseDelay;
+	}
+
+	/** Prefetch right away, so that the props near the player start loading before the first impact. */
+	UpdateStreamedWaves();
+}
+
+void UReacousticSoundStreamingManager::Deinitialize(UReacousticSubsystem* Subsystem)
+{
+	ReleaseAll();
+	Super::Deinitialize(Subsystem);
+}
+
+void UReacousticSoundStreamingManager::Tick(const float DeltaTime)
+{
+	TimeSinceUpdate += DeltaTime;
+	if (TimeSinceUpdate < UpdateInterval) { return; }
+
+	TimeSinceUpdate = FMath::Fmod(TimeSinceUpdate, UpdateInterval);
+	UpdateStreamedWaves();
+}
+
+void UReacousticSoundStreamingManager::RequestSoundData(const FReacousticSoundData& SoundData)
+{
+	RequestWave(SoundData.ImpactWaveAsset);
+	RequestWave(SoundData.SlidingWaveAsset);
+}
+
+USoundWave* UReacousticSoundStreamingManager::RequestWave(const TSoftObjectPtr<USoundWave>& Wave)
+{
+	if (Wave.IsNull()) { return nullptr; }
+
+	FStreamedWave& StreamedWave {StreamedWaves.FindOrAdd(Wave.ToSoftObjectPath())};
+	StreamedWave.LastRequestTime = GetTime();
+
+	if (!StreamedWave.Handle)
+	{
+		StreamedWave.Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(Wave.ToSoftObjectPath(), FStreamableDelegate(),
+			FStreamableManager::AsyncLoadHighPriority, false, false, TEXT("ReacousticWave"));
+	}
+	return Wave.Get();
+}
+
+void UReacousticSoundStreamingManager::ReleaseAll()
+{
+	for (TPair<FSoftObjectPath, FStreamedWave>& StreamedWave : StreamedWaves)
+	{
+		if (StreamedWave.Value.Handle)
+		{
+			StreamedWave.Value.Handle->ReleaseHandle();
+		}
+	}
+	StreamedWaves.Empty();
+	SET_DWORD_STAT(STAT_ReacousticStreamedWaves, 0);
+}
+
+void UReacousticSoundStreamingManager::UpdateStreamedWaves()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(Reacoustic::UpdateStreamedWaves);
+
+	const UReacousticSubsystem* Subsystem {GetOwner()};
+	if (!Subsystem || !Subsystem->ReacousticSoundDataAsset) { return; }
+
+	/** Surfaces are shared by every impact, so their waves are always kept loaded. */
+	for (int32 SurfaceType {0}; SurfaceType < SurfaceType_Max; ++SurfaceType)
+	{
+		if (const FReacousticSoundData* SoundData {Subsystem->ReacousticSoundDataAsset->Find(Subsystem->FindSurfaceSoundDataHandle(static_cast<EPhysicalSurface>(SurfaceType)))})
+		{
+			RequestSoundData(*SoundData);
+		}
+	}
+
+	FVector ListenerLocation;
+	const bool HasListener {Subsystem->GetListenerLocation(ListenerLocation)};
+	const double PrefetchRadiusSquared {FMath::Square(static_cast<double>(PrefetchRadius))};
+
+	for (const UReacousticComponent* Component : Subsystem->GetReacousticComponents())
+	{
+		const AActor* ComponentOwner {Component ? Component->GetOwner() : nullptr};
+		if (!ComponentOwner) { continue; }
+
+		/** Without streaming, the waves of every registered prop are loaded. */
+		if (UseStreaming && (!HasListener || FVector::DistSquared(ListenerLocation, ComponentOwner->GetActorLocation()) > PrefetchRadiusSquared))
+		{
+			continue;
+		}
+
+		if (const FReacousticSoundData* SoundData {Component->GetSoundData()})
+		{
+			RequestSoundData(*SoundData);
+		}
+	}
+
+	if (UseStreaming)
+	{
+		const double Time {GetTime()};
+		for (auto Iterator {StreamedWaves.CreateIterator()}; Iterator; ++Iterator)
+		{
+			if (Time - Iterator->Value.LastRequestTime <= ReleaseDelay) { continue; }
+
+			if (Iterator->Value.Handle)
+			{
+				Iterator->Value.Handle->ReleaseHandle();
+			}
+			UE_LOG(LogReacousticSoundStreamingManager, Verbose, TEXT("Released '%s' after %.1f seconds of inactivity."), *Iterator->Key.ToString(), ReleaseDelay);
+			Iterator.RemoveCurrent();
+		}
+	}
+
+	SET_DWORD_STAT(STAT_ReacousticStreamedWaves, StreamedWaves.Num());
+}
+
+double UReacousticSoundStreamingManager::GetTime() const
+{
+	const UWorld* World {GetOwner() ? GetOwner()->GetWorld() : nullptr};
+	return World ? World->GetTimeSeconds() : 0.0;
+}
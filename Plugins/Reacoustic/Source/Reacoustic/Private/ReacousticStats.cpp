@@ -0,0 +1,41 @@
+// Copyright (c) 2022-present Nino Saglia. All Rights Reserved.
+// Written by Nino Saglia.
+
+#include "ReacousticStats.h"
+#include "HAL/PlatformTime.h"
+
+DEFINE_STAT(STAT_ReacousticProcessImpactQueue);
+DEFINE_STAT(STAT_ReacousticProcessPopulationQueue);
+DEFINE_STAT(STAT_ReacousticUpdateHitNotifications);
+DEFINE_STAT(STAT_ReacousticUpdateSlidingLoops);
+
+DEFINE_STAT(STAT_ReacousticEventsReceived);
+DEFINE_STAT(STAT_ReacousticEventsCulled);
+DEFINE_STAT(STAT_ReacousticEventsCulledByDistance);
+DEFINE_STAT(STAT_ReacousticEventsMerged);
+DEFINE_STAT(STAT_ReacousticVoicesStarted);
+DEFINE_STAT(STAT_ReacousticActiveVoices);
+DEFINE_STAT(STAT_ReacousticActiveSlidingLoops);
+DEFINE_STAT(STAT_ReacousticRegisteredComponents);
+DEFINE_STAT(STAT_ReacousticStreamedWaves);
+DEFINE_STAT(STAT_ReacousticPopulationQueue);
+
+UE_TRACE_CHANNEL_DEFINE(ReacousticChannel);
+
+UE_TRACE_EVENT_BEGIN(Reacoustic, Impact)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, ComponentId)
+	UE_TRACE_EVENT_FIELD(float, Strength)
+	UE_TRACE_EVENT_FIELD(float, OnsetTimestamp)
+	UE_TRACE_EVENT_FIELD(uint8, Decision)
+UE_TRACE_EVENT_END()
+
+void TraceReacousticImpact(const UObject* Component, const float Strength, const float OnsetTimestamp, const EReacousticImpactDecision Decision)
+{
+	UE_TRACE_LOG(Reacoustic, Impact, ReacousticChannel)
+		<< Impact.Cycle(FPlatformTime::Cycles64())
+		<< Impact.ComponentId(Component ? Component->GetUniqueID() : 0)
+		<< Impact.Strength(Strength)
+		<< Impact.OnsetTimestamp(OnsetTimestamp)
+		<< Impact.Decision(static_cast<uint8>(Decision));
+}
@@ -3,19 +3,26 @@
 
 #include "ReacousticSubsystem.h"
 #include "ReacousticComponent.h"
+#include "ReacousticAudioComponentManager.h"
+#include "ReacousticSlidingAudioManager.h"
+#include "ReacousticHitStormBenchmark.h"
+#include "ReacousticSoundStreamingManager.h"
+#include "ReacousticLevelManifest.h"
 #include "Components/SceneComponent.h"
 #include "Engine/StaticMeshActor.h"
+#include "Engine/StaticMesh.h"
 #include "Kismet/GameplayStatics.h"
 #include "Components/SceneComponent.h"
 #include "ReacousticDataTypes.h"
+#include "HAL/IConsoleManager.h"
+#include "GameFramework/PlayerController.h"
+#include "ReacousticStats.h"
 
 DEFINE_LOG_CATEGORY_CLASS(UReacousticSubsystem, LogReacousticSubsystem);
 
 UReacousticSubsystem::UReacousticSubsystem()
 {
 	Settings = GetMutableDefault<UReacousticProjectSettings>();
-
-	//TODO: get all the settings from the project settngs and use them to populate wold with reacoustic objects without any functions in the level blueprint.
 }
 
 void UReacousticSubsystem::PostInitProperties()
@@ -31,14 +38,352 @@ void UReacousticSubsystem::PostInitProperties()
 	UWorld* World = GetWorld();
 	if (World)
 	{
-		World->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &UReacousticSubsystem::OnActorSpawned));
+		ActorSpawnedDelegateHandle = World->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &UReacousticSubsystem::OnActorSpawned));
+	}
+}
+
+void UReacousticSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	AudioComponentManager = NewObject<UReacousticAudioComponentManager>(this);
+	AudioComponentManager->Initialize(this);
+
+	SlidingAudioManager = NewObject<UReacousticSlidingAudioManager>(this);
+	SlidingAudioManager->Initialize(this);
+
+	LoadGeneratedSoundData();
+
+	if (Settings)
+	{
+		HitNotificationOwnerComponentClasses = Settings->LoadHitNotificationOwnerComponentClasses();
+	}
+
+	/** Build the mesh and surface lookup tables up front, so that the first impacts do not have to. */
+	RebuildSoundDataIndex();
+
+	SoundStreamingManager = NewObject<UReacousticSoundStreamingManager>(this);
+	SoundStreamingManager->Initialize(this);
+
+	/** Populate the world from the project settings, so that levels do not need to call PopulateWorldWithBPReacousticComponents themselves. */
+	if (Settings && Settings->AutoPopulateOnBeginPlay)
+	{
+		if (const TSubclassOf<UReacousticComponent> ComponentClass {LoadDefaultComponentClass()})
+		{
+			PopulateWorldWithBPReacousticComponents(ComponentClass);
+		}
+	}
+}
+
+void UReacousticSubsystem::Deinitialize()
+{
+	if (UWorld* World {GetWorld()})
+	{
+		World->RemoveOnActorSpawnedHandler(ActorSpawnedDelegateHandle);
+	}
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedDelegateHandle);
+	if (AudioComponentManager)
+	{
+		AudioComponentManager->Deinitialize(this);
+		AudioComponentManager = nullptr;
+	}
+	if (SlidingAudioManager)
+	{
+		SlidingAudioManager->Deinitialize(this);
+		SlidingAudioManager = nullptr;
+	}
+	if (SoundStreamingManager)
+	{
+		SoundStreamingManager->Deinitialize(this);
+		SoundStreamingManager = nullptr;
+	}
+	if (HitStormBenchmark)
+	{
+		HitStormBenchmark->Finish();
+		HitStormBenchmark->Deinitialize(this);
+		HitStormBenchmark = nullptr;
+	}
+	PopulationQueue.Empty();
+	PopulationQueueIndex = 0;
+	HasCompletedPopulation = false;
+	
+	Super::Deinitialize();
+}
+
+TStatId UReacousticSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UReacousticSubsystem, STATGROUP_Tickables);
+}
+
+void UReacousticSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (IsPopulating())
+	{
+		const bool UseBudget {Settings && Settings->UseIncrementalPopulation};
+		ProcessPopulationQueue(UseBudget ? Settings->PopulationFrameBudget / 1000.0 : 0.0);
+	}
+
+	UpdateListenerLocation();
+	UpdateHitNotifications();
+	ProcessImpactQueue();
+
+	if (HitStormBenchmark && HitStormBenchmark->IsRunning())
+	{
+		HitStormBenchmark->Tick(DeltaTime);
+	}
+
+	if (SlidingAudioManager)
+	{
+		SlidingAudioManager->Tick(DeltaTime);
+	}
+
+	if (SoundStreamingManager)
+	{
+		SoundStreamingManager->Tick(DeltaTime);
+	}
+}
+
+void UReacousticSubsystem::UpdateHitNotifications()
+{
+	if (!Settings || !Settings->UseSleepAwareHitNotifications || ReacousticComponents.IsEmpty()) { return; }
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(Reacoustic::UpdateHitNotifications);
+	SCOPE_CYCLE_COUNTER(STAT_ReacousticUpdateHitNotifications);
+
+	const float SpeedThresholdSquared {FMath::Square(Settings->HitNotificationSpeedThreshold)};
+	const float ListenerRadiusSquared {FMath::Square(Settings->HitNotificationListenerRadius)};
+	const int32 UpdateCount {FMath::Min(FMath::Max(Settings->HitNotificationUpdatesPerFrame, 1), ReacousticComponents.Num())};
+
+	for (int32 Count {0}; Count < UpdateCount; ++Count)
+	{
+		if (HitNotificationUpdateIndex >= ReacousticComponents.Num())
+		{
+			HitNotificationUpdateIndex = 0;
+		}
+
+		if (UReacousticComponent* Component {ReacousticComponents[HitNotificationUpdateIndex++]})
+		{
+			Component->UpdateHitNotifications(HasListenerLocation, ListenerLocation, SpeedThresholdSquared, ListenerRadiusSquared);
+		}
+	}
+}
+
+bool UReacousticSubsystem::HasHitNotificationOwnerComponent(const AActor* Actor) const
+{
+	if (!Actor || HitNotificationOwnerComponentClasses.IsEmpty()) { return false; }
+
+	for (UClass* ComponentClass : HitNotificationOwnerComponentClasses)
+	{
+		if (Actor->FindComponentByClass(ComponentClass))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void UReacousticSubsystem::UpdateListenerLocation()
+{
+	const UWorld* World {GetWorld()};
+	const APlayerController* PlayerController {World ? World->GetFirstPlayerController() : nullptr};
+	HasListenerLocation = PlayerController != nullptr;
+	if (!HasListenerLocation) { return; }
+
+	FVector ListenerFrontDirection;
+	FVector ListenerRightDirection;
+	PlayerController->GetAudioListenerPosition(ListenerLocation, ListenerFrontDirection, ListenerRightDirection);
+}
+
+void UReacousticSubsystem::QueueImpact(UReacousticComponent* Component, UPrimitiveComponent* HitComponent, AActor* OtherActor,
+	UPrimitiveComponent* OtherComponent, const FVector& NormalImpulse, const FHitResult& Hit)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(Reacoustic::QueueImpact);
+	++CurrentImpactStats.EventsReceived;
+	
+	/** Hits without a physics simulating component or another actor can never produce a sound, so we don't queue them. */
+	if (!Component || !HitComponent || !HitComponent->IsSimulatingPhysics() || !OtherActor)
+	{
+		++CurrentImpactStats.EventsCulled;
+		return;
+	}
+
+	/** The velocities are sampled now, since they will have changed by the time the queue is processed. */
+	const FVector RelativeVelocity {HitComponent->GetComponentVelocity() - OtherActor->GetVelocity()};
+	ImpactQueue.Add(Component, HitComponent, OtherActor, OtherComponent, NormalImpulse, RelativeVelocity, Hit);
+}
+
+void UReacousticSubsystem::ProcessImpactQueue()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(Reacoustic::ProcessImpactQueue);
+	SCOPE_CYCLE_COUNTER(STAT_ReacousticProcessImpactQueue);
+
+	const double StartTime {FPlatformTime::Seconds()};
+	const int32 ImpactCount {ImpactQueue.Num()};
+	SortedImpactIndices.Reset();
+	
+	/** Calculate the impact strengths for all queued hits at once, and discard the hits that are too weak to be heard. */
+	ImpactQueue.Kinematics.CalculateStrengths(ImpactQueue.Strengths);
+	for (int32 Index {0}; Index < ImpactCount; ++Index)
+	{
+		if (ImpactQueue.Strengths[Index] > UReacousticComponent::MinimumImpactStrength)
+		{
+			SortedImpactIndices.Add(Index);
+		}
+		else
+		{
+			TraceReacousticImpact(ImpactQueue.Components[Index].Get(), ImpactQueue.Strengths[Index], -1.0f, EReacousticImpactDecision::CulledTooWeak);
+		}
+	}
+	CurrentImpactStats.EventsCulled += ImpactCount - SortedImpactIndices.Num();
+
+	/** Process the loudest impacts first, so that they are the ones that are kept when a region is full and when voices are stolen. */
+	const TArray<float>& Strengths {ImpactQueue.Strengths};
+	SortedImpactIndices.Sort([&Strengths](const int32 A, const int32 B) { return Strengths[A] > Strengths[B]; });
+
+	if (Settings && Settings->UseImpactMerging)
+	{
+		MergeImpacts();
+	}
+
+	const int32 MaxImpactsPerRegion {Settings ? Settings->MaxImpactsPerRegion : 4};
+	const double InverseRegionSize {1.0 / (Settings ? FMath::Max(Settings->ImpactRegionSize, 1.0f) : 200.0f)};
+	RegionImpactCounts.Reset();
+	
+	for (const int32 Index : SortedImpactIndices)
+	{
+		const FVector& Location {ImpactQueue.Locations[Index]};
+		const FIntVector Region {FMath::FloorToInt(Location.X * InverseRegionSize), FMath::FloorToInt(Location.Y * InverseRegionSize), FMath::FloorToInt(Location.Z * InverseRegionSize)};
+		
+		UReacousticComponent* Component {ImpactQueue.Components[Index].Get()};
+		if (!Component)
+		{
+			++CurrentImpactStats.EventsCulled;
+			continue;
+		}
+
+		/** Impacts that the listener cannot hear are rejected before any filtering or voice allocation, and do not count towards the region limit. */
+		const float Strength {ImpactQueue.Strengths[Index]};
+		if (HasListenerLocation && !Component->IsAudibleFrom(ListenerLocation, Location))
+		{
+			++CurrentImpactStats.EventsCulled;
+			++CurrentImpactStats.EventsCulledByDistance;
+			TraceReacousticImpact(Component, Strength, -1.0f, EReacousticImpactDecision::CulledByDistance);
+			continue;
+		}
+
+		int32& RegionImpactCount {RegionImpactCounts.FindOrAdd(Region)};
+		if (RegionImpactCount >= MaxImpactsPerRegion)
+		{
+			++CurrentImpactStats.EventsCulled;
+			TraceReacousticImpact(Component, Strength, -1.0f, EReacousticImpactDecision::CulledByRegion);
+			continue;
+		}
+
+		/** Impacts on props whose wave is still streaming in are dropped. The request keeps the wave loaded for the next impacts. */
+		if (!Component->RequestImpactWave())
+		{
+			++CurrentImpactStats.EventsCulled;
+			TraceReacousticImpact(Component, Strength, -1.0f, EReacousticImpactDecision::CulledNotLoaded);
+			continue;
+		}
+
+		const FHitResult& Hit {ImpactQueue.HitResults[Index]};
+		if (!Component->FilterImpact(Strength, Hit))
+		{
+			++CurrentImpactStats.EventsCulled;
+			TraceReacousticImpact(Component, Strength, -1.0f, EReacousticImpactDecision::CulledByFilter);
+			continue;
+		}
+		
+		++RegionImpactCount;
+		const bool IsPlayed {Component->PlayImpact(ImpactQueue.HitComponents[Index].Get(), ImpactQueue.OtherActors[Index].Get(),
+			ImpactQueue.OtherComponents[Index].Get(), ImpactQueue.NormalImpulses[Index], Hit)};
+		if (IsPlayed)
+		{
+			++CurrentImpactStats.VoicesStarted;
+		}
+		TraceReacousticImpact(Component, Strength, Component->GetLatestOnsetTimestamp(),
+			IsPlayed ? EReacousticImpactDecision::Played : EReacousticImpactDecision::CulledNoVoice);
 	}
+
+	INC_DWORD_STAT_BY(STAT_ReacousticEventsReceived, CurrentImpactStats.EventsReceived);
+	INC_DWORD_STAT_BY(STAT_ReacousticEventsCulled, CurrentImpactStats.EventsCulled);
+	INC_DWORD_STAT_BY(STAT_ReacousticEventsCulledByDistance, CurrentImpactStats.EventsCulledByDistance);
+	INC_DWORD_STAT_BY(STAT_ReacousticEventsMerged, CurrentImpactStats.EventsMerged);
+	INC_DWORD_STAT_BY(STAT_ReacousticVoicesStarted, CurrentImpactStats.VoicesStarted);
+	SET_DWORD_STAT(STAT_ReacousticActiveVoices, AudioComponentManager ? AudioComponentManager->GetActiveVoiceCount() : 0);
+	SET_DWORD_STAT(STAT_ReacousticRegisteredComponents, ReacousticComponents.Num());
+
+	ImpactQueue.Reset();
+	if (CurrentImpactStats.EventsCulledByDistance > 0 || CurrentImpactStats.VoicesStarted > 0)
+	{
+		UE_LOG(LogReacousticSubsystem, VeryVerbose, TEXT("Impacts played: %d, culled by distance: %d"), CurrentImpactStats.VoicesStarted, CurrentImpactStats.EventsCulledByDistance);
+	}
+	LastImpactStats = CurrentImpactStats;
+	CurrentImpactStats = FReacousticImpactStats();
+	LastImpactProcessTime = FPlatformTime::Seconds() - StartTime;
 }
 
+void UReacousticSubsystem::MergeImpacts()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(Reacoustic::MergeImpacts);
+
+	const UWorld* World {GetWorld()};
+	const double Time {World ? World->GetTimeSeconds() : 0.0};
+	ImpactHash.Configure(Settings->ImpactMergeRadius, Settings->ImpactMergeWindow);
+	ImpactHash.BeginFrame(Time);
 
+	/** The impacts are sorted from loud to quiet, so the loudest impact of every group is the one that is kept. */
+	int32 KeptCount {0};
+	for (int32 SortedIndex {0}; SortedIndex < SortedImpactIndices.Num(); ++SortedIndex)
+	{
+		const int32 Index {SortedImpactIndices[SortedIndex]};
+		const FVector& Location {ImpactQueue.Locations[Index]};
+		const UObject* OtherObject {ImpactQueue.OtherComponents[Index].IsValid() ? static_cast<const UObject*>(ImpactQueue.OtherComponents[Index].Get()) : ImpactQueue.OtherActors[Index].Get()};
+		const uint64 PairKey {FReacousticImpactHash::MakePairKey(ImpactQueue.HitComponents[Index].Get(), OtherObject)};
+
+		const float Strength {ImpactQueue.Strengths[Index]};
+
+		const int32 MatchIndex {ImpactHash.FindMatch(PairKey, Location)};
+		if (MatchIndex == INDEX_NONE)
+		{
+			ImpactHash.Add(PairKey, Location, Time, Strength, Index);
+			SortedImpactIndices[KeptCount++] = Index;
+			continue;
+		}
+
+		const int32 KeptIndex {ImpactHash[MatchIndex].QueueIndex};
+		if (KeptIndex != INDEX_NONE)
+		{
+			/** The impacts of the same frame are merged into the louder impact that was kept before this one. */
+			ImpactQueue.Strengths[KeptIndex] = FReacousticImpactHash::CombineStrengths(ImpactQueue.Strengths[KeptIndex], Strength);
+			ImpactHash.Update(MatchIndex, Time, ImpactQueue.Strengths[KeptIndex], KeptIndex);
+		}
+		else if (Strength > ImpactHash[MatchIndex].Strength)
+		{
+			/** The matching impact played during a previous frame and was quieter, so this impact is played as well,
+			 *	and impacts of this frame that match it are merged into it. */
+			ImpactHash.Update(MatchIndex, Time, Strength, Index);
+			SortedImpactIndices[KeptCount++] = Index;
+			continue;
+		}
+
+		++CurrentImpactStats.EventsCulled;
+		++CurrentImpactStats.EventsMerged;
+		TraceReacousticImpact(ImpactQueue.Components[Index].Get(), Strength, -1.0f, EReacousticImpactDecision::Merged);
+	}
+	SortedImpactIndices.SetNum(KeptCount, false);
+}
+
+/** Actors spawned after population has started are queued and receive their component on the next tick,
+ *	since the actor's components are not guaranteed to be fully set up when the spawn delegate is broadcast. */
 void UReacousticSubsystem::OnActorSpawned(AActor* Actor)
 {
+	if (IgnoresSpawnedActors || !PopulationComponentClass || !UReacousticLevelManifest::IsAllowedActor(Actor, PopulationActorClasses)) { return; }
 	
+	PopulationQueue.Add({Actor, false});
 }
 
 void UReacousticSubsystem::RegisterComponent(UReacousticComponent* Component)
@@ -72,18 +417,80 @@ bool UReacousticSubsystem::IsReacousticCompatible(AActor* Actor)
 }
 
 /* Adds a reacousticComponent derived component to an actor. and returns the pointer to this component.*/
-void UReacousticSubsystem::AddBPReacousticComponentToActor(AActor* Actor, TSubclassOf<UReacousticComponent> ComponentClass, FReacousticSoundData MeshSoundData)
+UReacousticComponent* UReacousticSubsystem::AddBPReacousticComponentToActor(AActor* Actor, TSubclassOf<UReacousticComponent> ComponentClass, const FReacousticSoundData& MeshSoundData)
+{
+	UReacousticComponent* ReacousticComponent {CreateReacousticComponent(Actor, ComponentClass)};
+	if (!ReacousticComponent) { return nullptr; }
+
+	ReacousticComponent->TransferData(ReacousticSoundDataAsset, ReacousticSoundDataRefMap, MeshSoundData);
+	ReacousticComponent->RegisterComponent();
+	return ReacousticComponent;
+}
+
+UReacousticComponent* UReacousticSubsystem::AddReacousticComponentToActor(AActor* Actor, TSubclassOf<UReacousticComponent> ComponentClass, const FReacousticSoundDataHandle SoundDataHandle)
+{
+	UReacousticComponent* ReacousticComponent {CreateReacousticComponent(Actor, ComponentClass)};
+	if (!ReacousticComponent) { return nullptr; }
+
+	ReacousticComponent->TransferDataHandle(ReacousticSoundDataAsset, ReacousticSoundDataRefMap, SoundDataHandle);
+	ReacousticComponent->RegisterComponent();
+	return ReacousticComponent;
+}
+
+void UReacousticSubsystem::LoadGeneratedSoundData()
+{
+	if (!Settings) { return; }
+
+	/** Sound data that was assigned to the subsystem before the world began play is kept. */
+	if (!ReacousticSoundDataAsset || ReacousticSoundDataAsset->GetPackage() == GetTransientPackage())
+	{
+		if (UReacousticSoundDataAsset* SoundDataAsset {Cast<UReacousticSoundDataAsset>(Settings->GeneratedSoundDataAsset.TryLoad())})
+		{
+			ReacousticSoundDataAsset = SoundDataAsset;
+		}
+	}
+
+	if (!ReacousticSoundDataRefMap || ReacousticSoundDataRefMap->GetPackage() == GetTransientPackage())
+	{
+		if (UReacousticSoundDataRef_Map* SoundDataRefMap {Cast<UReacousticSoundDataRef_Map>(Settings->GeneratedSoundDataRefMap.TryLoad())})
+		{
+			ReacousticSoundDataRefMap = SoundDataRefMap;
+		}
+	}
+}
+
+TSubclassOf<UReacousticComponent> UReacousticSubsystem::LoadDefaultComponentClass() const
+{
+	if (!Settings || Settings->ReacousticComponent.IsNull()) { return nullptr; }
+
+	/** The settings can reference either the blueprint asset or its generated class. */
+	FSoftObjectPath ClassPath {Settings->ReacousticComponent};
+	if (!ClassPath.GetAssetName().EndsWith(TEXT("_C")))
+	{
+		ClassPath = FSoftObjectPath(ClassPath.GetLongPackageName() + TEXT(".") + ClassPath.GetAssetName() + TEXT("_C"));
+	}
+
+	UClass* ComponentClass {Cast<UClass>(ClassPath.TryLoad())};
+	if (!ComponentClass || !ComponentClass->IsChildOf(UReacousticComponent::StaticClass()))
+	{
+		UE_LOG(LogReacousticSubsystem, Warning, TEXT("'%s' is not a valid Reacoustic component class."), *ClassPath.ToString());
+		return nullptr;
+	}
+	return ComponentClass;
+}
+
+UReacousticComponent* UReacousticSubsystem::CreateReacousticComponent(AActor* Actor, TSubclassOf<UReacousticComponent> ComponentClass)
 {
 	if (!ReacousticSoundDataRefMap || !ReacousticSoundDataAsset)
 	{
-		return;
+		return nullptr;
 	}
 	
     UActorComponent* NewComponent {nullptr};
     if (!Actor)
     {
         UE_LOG(LogReacousticSubsystem, Warning, TEXT("AddComponentToActor was called without passing an actor pointer."))
-        return;
+        return nullptr;
     }
     if (Actor->GetComponentByClass(ComponentClass))
     {
@@ -94,14 +501,7 @@ void UReacousticSubsystem::AddBPReacousticComponentToActor(AActor* Actor, TSubcl
     {
         NewComponent = Actor->AddComponentByClass(ComponentClass, false, FTransform(), true);
     }
-    if(NewComponent)
-    {
-        if(UReacousticComponent* ReacousticComponent {Cast<UReacousticComponent>(NewComponent)})
-        {
-            ReacousticComponent->TransferData(ReacousticSoundDataAsset, ReacousticSoundDataRefMap, MeshSoundData);
-            ReacousticComponent->RegisterComponent();
-        }
-    }
+    return Cast<UReacousticComponent>(NewComponent);
 }
 
 TArray<AActor*> UReacousticSubsystem::GetCompatibleActorsOfClass(UClass* ClassType)
@@ -132,7 +532,8 @@ TArray<AActor*> UReacousticSubsystem::GetCompatibleActorsOfClass(UClass* ClassTy
 }
 
 
-/** For current use: adds a blueprint component derrived from the reacoustics c++ component. */
+/** For current use: adds a blueprint component derrived from the reacoustics c++ component.
+ *	When incremental population is enabled in the project settings, the compatible actors are queued and processed over multiple frames. */
 void UReacousticSubsystem::PopulateWorldWithBPReacousticComponents(TSubclassOf<class UReacousticComponent> ComponentClass)
 {
 	if (!ComponentClass)
@@ -146,48 +547,428 @@ void UReacousticSubsystem::PopulateWorldWithBPReacousticComponents(TSubclassOf<c
 		return;
 	}
 
-	TArray<AActor*> CompatibleActors {GetCompatibleActorsOfClass(AStaticMeshActor::StaticClass())};
-	for (AActor* Actor : CompatibleActors)
+	/** A world is only populated once, so that actors never receive a second component of a different class,
+	 *	for example when a level blueprint still populates a world that was already populated on begin play. */
+	if (PopulationComponentClass)
+	{
+		if (PopulationComponentClass == ComponentClass)
+		{
+			UE_LOG(LogReacousticSubsystem, Verbose, TEXT("Skipped population with %s because the world was already populated with it."), *ComponentClass->GetName());
+		}
+		else
+		{
+			UE_LOG(LogReacousticSubsystem, Warning, TEXT("Skipped population with %s because the world was already populated with %s. Disable Auto Populate On Begin Play to populate the world with a different component class."),
+				*ComponentClass->GetName(), *PopulationComponentClass->GetName());
+		}
+		return;
+	}
+
+	UWorld* World {GetWorld()};
+	if (!World) { return; }
+
+	const double StartTime {FPlatformTime::Seconds()};
+	
+	RebuildSoundDataIndex();
+
+	PopulationComponentClass = ComponentClass;
+	PopulationActorClasses = Settings ? Settings->LoadAutoPopulateActorClasses() : TArray<UClass*> {AStaticMeshActor::StaticClass()};
+	
+	int32 QueuedCount {0};
+	for (const ULevel* Level : World->GetLevels())
+	{
+		if (Level && Level->bIsVisible)
+		{
+			QueuedCount += QueueLevelForPopulation(Level);
+		}
+	}
+
+	if (!LevelAddedDelegateHandle.IsValid())
+	{
+		LevelAddedDelegateHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UReacousticSubsystem::OnLevelAddedToWorld);
+	}
+
+	if (Settings && Settings->UseIncrementalPopulation)
+	{
+		UE_LOG(LogReacousticSubsystem, Log, TEXT("Queued %d actors for incremental population with a budget of %.2f ms per frame."),
+			QueuedCount, Settings->PopulationFrameBudget);
+		return;
+	}
+	
+	ProcessPopulationQueue(0.0);
+
+	const double ElapsedMilliseconds {(FPlatformTime::Seconds() - StartTime) * 1000.0};
+	UE_LOG(LogReacousticSubsystem, Log, TEXT("Populated world with Reacoustic components for %d actors in %.2f ms. (%d mapped meshes)"),
+		QueuedCount, ElapsedMilliseconds, MeshSoundDataIndex.Num());
+}
+
+int32 UReacousticSubsystem::QueueLevelForPopulation(const ULevel* Level)
+{
+	if (!Level) { return 0; }
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(Reacoustic::QueueLevelForPopulation);
+
+	/** Cooked levels list their compatible actors, so they do not need to be searched. */
+	if (const UReacousticLevelManifest* Manifest {UReacousticLevelManifest::Find(Level)})
 	{
-		if (!Actor)
+		PopulationQueue.Reserve(PopulationQueue.Num() + Manifest->Actors.Num());
+		for (AActor* Actor : Manifest->Actors)
+		{
+			PopulationQueue.Add({Actor, true});
+		}
+		UE_LOG(LogReacousticSubsystem, Verbose, TEXT("Queued %d actors from the manifest of %s."), Manifest->Actors.Num(), *Level->GetOutermost()->GetName());
+		return Manifest->Actors.Num();
+	}
+
+	int32 QueuedCount {0};
+	for (AActor* Actor : Level->Actors)
+	{
+		if (UReacousticLevelManifest::IsAllowedActor(Actor, PopulationActorClasses) && IsReacousticCompatible(Actor))
+		{
+			PopulationQueue.Add({Actor, true});
+			++QueuedCount;
+		}
+	}
+	return QueuedCount;
+}
+
+void UReacousticSubsystem::OnLevelAddedToWorld(ULevel* Level, UWorld* World)
+{
+	if (World != GetWorld() || !PopulationComponentClass) { return; }
+
+	QueueLevelForPopulation(Level);
+}
+
+int32 UReacousticSubsystem::PopulateActor(AActor* Actor, TSubclassOf<UReacousticComponent> ComponentClass)
+{
+	if (!Actor || !ComponentClass) { return 0; }
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(Reacoustic::PopulateActor);
+
+	int32 AddedCount {0};
+	TArray<UStaticMeshComponent*> Components{};
+	Actor->GetComponents<UStaticMeshComponent>(Components);
+	for (const UStaticMeshComponent* StaticMeshComponent : Components)
+	{
+		if (!StaticMeshComponent)
 		{
 			continue;
 		}
+		
+		/** Components share the sound data in the asset through a handle, instead of receiving a copy. */
+		if (AddReacousticComponentToActor(Actor, ComponentClass, FindMeshSoundDataHandle(StaticMeshComponent)))
+		{
+			++AddedCount;
+		}
+	}
+	return AddedCount;
+}
+
+void UReacousticSubsystem::ProcessPopulationQueue(double Budget)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(Reacoustic::ProcessPopulationQueue);
+	SCOPE_CYCLE_COUNTER(STAT_ReacousticProcessPopulationQueue);
 
-		TArray<UActorComponent*> Components{};
-		Actor->GetComponents(Components);
-		for (UActorComponent* ActorComponent : Components)
+	const double StartTime {FPlatformTime::Seconds()};
+	
+	while (PopulationQueueIndex < PopulationQueue.Num())
+	{
+		const FReacousticPopulationEntry& Entry {PopulationQueue[PopulationQueueIndex++]};
+		AActor* Actor {Entry.Actor.Get()};
+		
+		/** Actors that were spawned during population have not been checked for compatibility yet. */
+		if (Actor && (Entry.IsCompatible || IsReacousticCompatible(Actor)))
 		{
-			if (!ActorComponent)
-			{
-				continue;
-			}
+			PopulatedComponentCount += PopulateActor(Actor, PopulationComponentClass);
+		}
 
-			if (const UStaticMeshComponent* StaticMeshComponent {Cast<UStaticMeshComponent>(ActorComponent)})
-			{
-				const FReacousticSoundData MeshSoundData {GetMeshSoundData(StaticMeshComponent)};
-				AddBPReacousticComponentToActor(Actor, ComponentClass, MeshSoundData);
-			}
+		if (Budget > 0.0 && FPlatformTime::Seconds() - StartTime >= Budget)
+		{
+			break;
 		}
 	}
+
+	SET_DWORD_STAT(STAT_ReacousticPopulationQueue, PopulationQueue.Num() - PopulationQueueIndex);
+
+	if (PopulationQueueIndex >= PopulationQueue.Num())
+	{
+		const int32 ComponentCount {PopulatedComponentCount};
+		PopulationQueue.Reset();
+		PopulationQueueIndex = 0;
+		PopulatedComponentCount = 0;
+		
+		UE_LOG(LogReacousticSubsystem, Verbose, TEXT("Finished population. Added %d Reacoustic components."), ComponentCount);
+
+		/** Spawned and streamed in actors are processed through the same queue, but only the initial population is reported. */
+		if (!HasCompletedPopulation)
+		{
+			HasCompletedPopulation = true;
+			OnPopulationCompleted.Broadcast(ComponentCount);
+		}
+	}
+}
+
+const FReacousticSoundData* UReacousticSubsystem::FindMeshSoundData(const UStaticMeshComponent* StaticMeshComponent) const
+{
+	return ReacousticSoundDataAsset ? ReacousticSoundDataAsset->Find(FindMeshSoundDataHandle(StaticMeshComponent)) : nullptr;
+}
+
+FReacousticSoundDataHandle UReacousticSubsystem::FindMeshSoundDataHandle(const UStaticMeshComponent* StaticMeshComponent) const
+{
+	if (!StaticMeshComponent || !ReacousticSoundDataAsset)
+	{
+		return FReacousticSoundDataHandle{};
+	}
+
+	const int32 SoundDataIndex {FindMeshSoundDataIndex(StaticMeshComponent->GetStaticMesh())};
+	return ReacousticSoundDataAsset->AudioData.IsValidIndex(SoundDataIndex) ? FReacousticSoundDataHandle{SoundDataIndex} : FReacousticSoundDataHandle{};
+}
+
+int32 UReacousticSubsystem::FindMeshSoundDataIndex(const UStaticMesh* Mesh) const
+{
+	if (!Mesh) { return INDEX_NONE; }
+	
+	UpdateSoundDataIndexIfStale();
+	
+	if (const int32* SoundDataIndex {MeshSoundDataIndex.Find(Mesh)})
+	{
+		return *SoundDataIndex;
+	}
+	return INDEX_NONE;
+}
+
+int32 UReacousticSubsystem::FindSurfaceSoundDataIndex(EPhysicalSurface SurfaceType) const
+{
+	UpdateSoundDataIndexIfStale();
+
+	return SurfaceType < SurfaceType_Max ? SurfaceSoundDataIndex[SurfaceType] : INDEX_NONE;
+}
+
+FReacousticSoundDataHandle UReacousticSubsystem::FindSurfaceSoundDataHandle(EPhysicalSurface SurfaceType) const
+{
+	if (!ReacousticSoundDataAsset) { return FReacousticSoundDataHandle{}; }
+
+	const int32 SoundDataIndex {FindSurfaceSoundDataIndex(SurfaceType)};
+	return ReacousticSoundDataAsset->AudioData.IsValidIndex(SoundDataIndex) ? FReacousticSoundDataHandle{SoundDataIndex} : FReacousticSoundDataHandle{};
 }
 
-FReacousticSoundData UReacousticSubsystem::GetMeshSoundData(const UStaticMeshComponent* StaticMeshComponent) const
+void UReacousticSubsystem::RebuildSoundDataIndex() const
 {
-	if (!StaticMeshComponent || !ReacousticSoundDataRefMap || !ReacousticSoundDataAsset)
+	TRACE_CPUPROFILER_EVENT_SCOPE(Reacoustic::RebuildSoundDataIndex);
+
+	MeshSoundDataIndex.Reset();
+	for (int32& SoundDataIndex : SurfaceSoundDataIndex)
+	{
+		SoundDataIndex = INDEX_NONE;
+	}
+	MappedSurfaceCount = 0;
+	IndexedRefMap = ReacousticSoundDataRefMap;
+	
+	if (!ReacousticSoundDataRefMap)
 	{
-		return FReacousticSoundData{};
+		IndexedMeshEntryCount = INDEX_NONE;
+		IndexedSurfaceEntryCount = INDEX_NONE;
+		return;
 	}
+	
+	IndexedMeshEntryCount = ReacousticSoundDataRefMap->MeshMapEntries.Num();
+	IndexedSurfaceEntryCount = ReacousticSoundDataRefMap->PhysicalMaterialMapEntries.Num();
+	
+	MeshSoundDataIndex.Reserve(IndexedMeshEntryCount);
 
+	/** The first entry for a mesh or surface wins, which matches the behavior of the previous linear search. */
 	for (const auto& [Mesh, SoundDataRef] : ReacousticSoundDataRefMap->MeshMapEntries)
 	{
-		UStaticMesh* MeshPtr {Mesh};
-		const int32 SoundDataRefValue {SoundDataRef};
+		if (Mesh && !MeshSoundDataIndex.Contains(Mesh))
+		{
+			MeshSoundDataIndex.Add(Mesh, SoundDataRef);
+		}
+	}
+	
+	for (const auto& [SurfaceType, SoundDataRef] : ReacousticSoundDataRefMap->PhysicalMaterialMapEntries)
+	{
+		if (SurfaceType < SurfaceType_Max && SurfaceSoundDataIndex[SurfaceType] == INDEX_NONE)
+		{
+			SurfaceSoundDataIndex[SurfaceType] = SoundDataRef;
+			++MappedSurfaceCount;
+		}
+	}
+	
+	/** Prebuild any missing onset indices so that the first impact of every sound does not have to build them.
+	 *	Generated and cooked sound data already contains its index. */
+	if (ReacousticSoundDataAsset)
+	{
+		for (const FReacousticSoundData& SoundData : ReacousticSoundDataAsset->AudioData)
+		{
+			SoundData.GetOnsetIndex();
+		}
+	}
+	
+	UE_LOG(LogReacousticSubsystem, Verbose, TEXT("Rebuilt sound data index with %d meshes and %d surfaces."), MeshSoundDataIndex.Num(), MappedSurfaceCount);
+}
+
+void UReacousticSubsystem::UpdateSoundDataIndexIfStale() const
+{
+	const bool IsStale {IndexedRefMap.Get() != ReacousticSoundDataRefMap
+		|| (ReacousticSoundDataRefMap && (IndexedMeshEntryCount != ReacousticSoundDataRefMap->MeshMapEntries.Num()
+		|| IndexedSurfaceEntryCount != ReacousticSoundDataRefMap->PhysicalMaterialMapEntries.Num()))};
+	
+	if (IsStale)
+	{
+		RebuildSoundDataIndex();
+	}
+}
 
-		if (StaticMeshComponent->GetStaticMesh() == MeshPtr)
+void UReacousticSubsystem::LogMemoryReport() const
+{
+	int32 SharedCount {0};
+	SIZE_T ComponentMemoryUsage {0};
+	SIZE_T CopiedMemoryUsage {0};
+	for (const UReacousticComponent* Component : ReacousticComponents)
+	{
+		if (!Component) { continue; }
+
+		if (Component->UsesSharedSoundData())
+		{
+			++SharedCount;
+		}
+		ComponentMemoryUsage += Component->GetSoundDataMemoryUsage();
+
+		/** The memory the component would use if it held a copy of its sound data. */
+		if (const FReacousticSoundData* SoundData {Component->GetSoundData()})
 		{
-			return ReacousticSoundDataAsset->AudioData[SoundDataRefValue];
+			CopiedMemoryUsage += SoundData->GetMemoryUsage();
 		}
 	}
-	return FReacousticSoundData{};
-}
\ No newline at end of file
+
+	SIZE_T SharedMemoryUsage {0};
+	if (ReacousticSoundDataAsset)
+	{
+		for (const FReacousticSoundData& SoundData : ReacousticSoundDataAsset->AudioData)
+		{
+			SharedMemoryUsage += SoundData.GetMemoryUsage();
+		}
+	}
+
+	const int32 ComponentCount {ReacousticComponents.Num()};
+	UE_LOG(LogReacousticSubsystem, Display, TEXT("Reacoustic memory report: %d components, %d using shared sound data."), ComponentCount, SharedCount);
+	UE_LOG(LogReacousticSubsystem, Display, TEXT("    Component sound data: %.2f KiB (%.1f bytes per component)"),
+		ComponentMemoryUsage / 1024.0, ComponentCount > 0 ? static_cast<double>(ComponentMemoryUsage) / ComponentCount : 0.0);
+	UE_LOG(LogReacousticSubsystem, Display, TEXT("    Shared sound data asset: %.2f KiB"), SharedMemoryUsage / 1024.0);
+	UE_LOG(LogReacousticSubsystem, Display, TEXT("    Per component copies would use: %.2f KiB, saved: %.2f KiB"),
+		CopiedMemoryUsage / 1024.0, (static_cast<double>(CopiedMemoryUsage) - static_cast<double>(ComponentMemoryUsage + SharedMemoryUsage)) / 1024.0);
+}
+
+static FAutoConsoleCommandWithWorld ReacousticMemoryReportCommand(
+	TEXT("Reacoustic.MemoryReport"),
+	TEXT("Logs the sound data memory usage of all Reacoustic components in the world."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UReacousticSubsystem* Subsystem {World ? World->GetSubsystem<UReacousticSubsystem>() : nullptr})
+		{
+			Subsystem->LogMemoryReport();
+		}
+	}));
+
+void UReacousticSubsystem::BenchmarkSoundDataIndex(int32 MeshCount, int32 LookupCount)
+{
+	MeshCount = FMath::Max(MeshCount, 1);
+	LookupCount = FMath::Max(LookupCount, 1);
+
+	UReacousticSoundDataRef_Map* BenchmarkRefMap {NewObject<UReacousticSoundDataRef_Map>(GetTransientPackage())};
+	BenchmarkRefMap->MeshMapEntries.Reserve(MeshCount);
+	for (int32 Index {0}; Index < MeshCount; ++Index)
+	{
+		FMeshToAudioMapEntry& Entry {BenchmarkRefMap->MeshMapEntries.AddDefaulted_GetRef()};
+		Entry.Mesh = NewObject<UStaticMesh>(GetTransientPackage());
+		Entry.ReacousticSoundDataRef = Index;
+	}
+
+	/** Every lookup asks for a random mapped mesh, like the components of a level with many different props. */
+	FRandomStream RandomStream {MeshCount};
+	TArray<const UStaticMesh*> LookupMeshes;
+	LookupMeshes.SetNumUninitialized(LookupCount);
+	for (const UStaticMesh*& Mesh : LookupMeshes)
+	{
+		Mesh = BenchmarkRefMap->MeshMapEntries[RandomStream.RandHelper(MeshCount)].Mesh;
+	}
+
+	int64 LinearChecksum {0};
+	const double LinearStartTime {FPlatformTime::Seconds()};
+	for (const UStaticMesh* LookupMesh : LookupMeshes)
+	{
+		for (const auto& [Mesh, SoundDataRef] : BenchmarkRefMap->MeshMapEntries)
+		{
+			if (Mesh == LookupMesh)
+			{
+				LinearChecksum += SoundDataRef;
+				break;
+			}
+		}
+	}
+	const double LinearTime {FPlatformTime::Seconds() - LinearStartTime};
+
+	UReacousticSoundDataRef_Map* PreviousRefMap {ReacousticSoundDataRefMap};
+	ReacousticSoundDataRefMap = BenchmarkRefMap;
+
+	const double BuildStartTime {FPlatformTime::Seconds()};
+	RebuildSoundDataIndex();
+	const double BuildTime {FPlatformTime::Seconds() - BuildStartTime};
+
+	int64 IndexChecksum {0};
+	const double IndexStartTime {FPlatformTime::Seconds()};
+	for (const UStaticMesh* LookupMesh : LookupMeshes)
+	{
+		IndexChecksum += FindMeshSoundDataIndex(LookupMesh);
+	}
+	const double IndexTime {FPlatformTime::Seconds() - IndexStartTime};
+
+	ReacousticSoundDataRefMap = PreviousRefMap;
+	RebuildSoundDataIndex();
+
+	UE_LOG(LogReacousticSubsystem, Display, TEXT("Reacoustic sound data lookup for %d components and %d mapped meshes: linear %.3f ms, index build %.3f ms + lookups %.3f ms (%.1fx).%s"),
+		LookupCount, MeshCount, LinearTime * 1000.0, BuildTime * 1000.0, IndexTime * 1000.0,
+		BuildTime + IndexTime > 0.0 ? LinearTime / (BuildTime + IndexTime) : 0.0,
+		LinearChecksum == IndexChecksum ? TEXT("") : TEXT(" The results do not match!"));
+}
+
+static FAutoConsoleCommandWithWorldAndArgs ReacousticBenchmarkSoundDataIndexCommand(
+	TEXT("Reacoustic.BenchmarkSoundDataIndex"),
+	TEXT("Compares looking up the sound data of components with a linear search and with the lookup index. Usage: Reacoustic.BenchmarkSoundDataIndex [MeshCount] [LookupCount]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (UReacousticSubsystem* Subsystem {World ? World->GetSubsystem<UReacousticSubsystem>() : nullptr})
+		{
+			const int32 MeshCount {Args.IsValidIndex(0) ? FCString::Atoi(*Args[0]) : 500};
+			const int32 LookupCount {Args.IsValidIndex(1) ? FCString::Atoi(*Args[1]) : 5000};
+			Subsystem->BenchmarkSoundDataIndex(MeshCount, LookupCount);
+		}
+	}));
+
+void UReacousticSubsystem::StartHitStormBenchmark(int32 PropCount, int32 FrameCount)
+{
+	if (!GetWorld() || !GetWorld()->HasBegunPlay())
+	{
+		UE_LOG(LogReacousticSubsystem, Warning, TEXT("The hit storm benchmark can only be started after the world has begun play."));
+		return;
+	}
+
+	if (!HitStormBenchmark)
+	{
+		HitStormBenchmark = NewObject<UReacousticHitStormBenchmark>(this);
+		HitStormBenchmark->Initialize(this);
+	}
+	HitStormBenchmark->Start(PropCount, FrameCount);
+}
+
+static FAutoConsoleCommandWithWorldAndArgs ReacousticHitStormBenchmarkCommand(
+	TEXT("Reacoustic.HitStormBenchmark"),
+	TEXT("Spawns a collapsing stack of physics props and writes per frame impact statistics to Saved/Reacoustic. Usage: Reacoustic.HitStormBenchmark [PropCount] [FrameCount]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (UReacousticSubsystem* Subsystem {World ? World->GetSubsystem<UReacousticSubsystem>() : nullptr})
+		{
+			const int32 PropCount {Args.IsValidIndex(0) ? FCString::Atoi(*Args[0]) : 500};
+			const int32 FrameCount {Args.IsValidIndex(1) ? FCString::Atoi(*Args[1]) : 600};
+			Subsystem->StartHitStormBenchmark(PropCount, FrameCount);
+		}
+	}));
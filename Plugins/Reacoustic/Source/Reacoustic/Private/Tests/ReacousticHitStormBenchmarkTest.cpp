@@ -0,0 +1,132 @@
+// Copyright (c) 2022-present Nino Saglia. All Rights Reserved.
+// Written by Nino Saglia.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "ReacousticSubsystem.h"
+#include "ReacousticHitStormBenchmark.h"
+#include "GameMapsSettings.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Paths.h"
+#include "Tests/AutomationCommon.h"
+
+namespace ReacousticHitStormBenchmarkTest
+{
+	constexpr int32 PropCount {500};
+	constexpr int32 FrameCount {600};
+
+	/** The time in seconds to wait for the benchmark to finish. */
+	constexpr double Timeout {120.0};
+
+	static TAutoConsoleVariable<FString> CVarMap(
+		TEXT("Reacoustic.HitStormTest.Map"),
+		TEXT(""),
+		TEXT("The map that the hit storm test loads. The game default map is loaded if this is empty."));
+
+	static TAutoConsoleVariable<float> CVarImpactProcessBudget(
+		TEXT("Reacoustic.HitStormTest.ImpactProcessBudgetMs"),
+		1.0f,
+		TEXT("The average time in milliseconds that filtering and playing impacts may take per frame during the hit storm test."));
+
+	/** Returns the Reacoustic subsystem of the loaded game world. */
+	UReacousticSubsystem* FindSubsystem()
+	{
+		const UWorld* World {AutomationCommon::GetAnyGameWorld()};
+		return World ? World->GetSubsystem<UReacousticSubsystem>() : nullptr;
+	}
+}
+
+/** Starts the hit storm benchmark in the loaded game world. */
+DEFINE_LATENT_AUTOMATION_COMMAND_ONE_PARAMETER(FReacousticStartHitStormBenchmarkCommand, FAutomationTestBase*, Test);
+
+bool FReacousticStartHitStormBenchmarkCommand::Update()
+{
+	using namespace ReacousticHitStormBenchmarkTest;
+
+	UReacousticSubsystem* Subsystem {FindSubsystem()};
+	if (!Subsystem)
+	{
+		Test->AddError(TEXT("The loaded map has no game world with a Reacoustic subsystem."));
+		return true;
+	}
+
+	Subsystem->StartHitStormBenchmark(PropCount, FrameCount);
+
+	const UReacousticHitStormBenchmark* Benchmark {Subsystem->GetHitStormBenchmark()};
+	if (!Benchmark || !Benchmark->IsRunning())
+	{
+		Test->AddError(TEXT("The hit storm benchmark could not be started."));
+	}
+	return true;
+}
+
+/** Waits for the hit storm benchmark to finish, then checks its summary against the budget. */
+DEFINE_LATENT_AUTOMATION_COMMAND_TWO_PARAMETER(FReacousticWaitForHitStormBenchmarkCommand, FAutomationTestBase*, Test, double, StartTime);
+
+bool FReacousticWaitForHitStormBenchmarkCommand::Update()
+{
+	using namespace ReacousticHitStormBenchmarkTest;
+
+	/** The timeout starts when the benchmark has started, not when the test was queued. */
+	if (StartTime <= 0.0)
+	{
+		StartTime = FPlatformTime::Seconds();
+	}
+
+	const UReacousticSubsystem* Subsystem {FindSubsystem()};
+	const UReacousticHitStormBenchmark* Benchmark {Subsystem ? Subsystem->GetHitStormBenchmark() : nullptr};
+	if (!Benchmark)
+	{
+		/** Starting the benchmark has already reported an error. */
+		return true;
+	}
+
+	if (Benchmark->IsRunning())
+	{
+		if (FPlatformTime::Seconds() - StartTime < Timeout) { return false; }
+
+		Test->AddError(FString::Printf(TEXT("The hit storm benchmark did not finish within %.0f seconds."), Timeout));
+		return true;
+	}
+
+	const UReacousticHitStormBenchmark::FSummary Summary {Benchmark->GetSummary()};
+	const double ImpactProcessBudgetMs {CVarImpactProcessBudget.GetValueOnGameThread()};
+
+	Test->AddInfo(FString::Printf(TEXT("Hit events: %lld, Voices started: %lld, Impact processing: %.3f ms average, %.3f ms max."),
+		Summary.EventsReceived, Summary.VoicesStarted, Summary.AverageImpactProcessTime * 1000.0, Summary.MaxImpactProcessTime * 1000.0));
+
+	Test->TestEqual(TEXT("Recorded frames"), Benchmark->GetRecordedFrameCount(), FrameCount);
+	Test->TestTrue(TEXT("Report was written"), !Benchmark->GetReportPath().IsEmpty() && FPaths::FileExists(Benchmark->GetReportPath()));
+	Test->TestTrue(TEXT("Hit events were received"), Summary.EventsReceived > 0);
+	Test->TestTrue(TEXT("Impact voices were started"), Summary.VoicesStarted > 0);
+	Test->TestTrue(FString::Printf(TEXT("Average impact processing time is within %.3f ms"), ImpactProcessBudgetMs),
+		Summary.AverageImpactProcessTime * 1000.0 <= ImpactProcessBudgetMs);
+	return true;
+}
+
+/** Loads a map, runs the hit storm benchmark in it and writes its CSV report to Saved/Reacoustic.
+ *	Fails if no impacts were heard, or if impact processing exceeds Reacoustic.HitStormTest.ImpactProcessBudgetMs on average.
+ *	Run headless with: UnrealEditor-Cmd <Project>.uproject -game -nullrhi -nosound -fps=60 -ExecCmds="Automation RunTests Reacoustic.Performance.HitStorm; Quit"
+ *	Add -ini:Engine:[ConsoleVariables]:Reacoustic.HitStormTest.Map=<Map> to run it in a map other than the game default map. */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FReacousticHitStormBenchmarkTest, "Reacoustic.Performance.HitStorm",
+	EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+bool FReacousticHitStormBenchmarkTest::RunTest(const FString& Parameters)
+{
+	using namespace ReacousticHitStormBenchmarkTest;
+
+	const FString MapName {CVarMap.GetValueOnGameThread().IsEmpty() ? UGameMapsSettings::GetGameDefaultMap() : CVarMap.GetValueOnGameThread()};
+	if (!AutomationOpenMap(MapName))
+	{
+		AddError(FString::Printf(TEXT("Failed to open map '%s'."), *MapName));
+		return false;
+	}
+
+	ADD_LATENT_AUTOMATION_COMMAND(FReacousticStartHitStormBenchmarkCommand(this));
+	ADD_LATENT_AUTOMATION_COMMAND(FReacousticWaitForHitStormBenchmarkCommand(this, 0.0));
+	return true;
+}
+
+#endif
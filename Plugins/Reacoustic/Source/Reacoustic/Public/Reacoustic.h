@@ -18,4 +18,10 @@ public:
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
 
+private:
+#if WITH_EDITOR
+	/** Handle for the delegate that builds the level manifests when levels are cooked. */
+	FDelegateHandle PreSaveWorldDelegateHandle;
+#endif
+
 };
@@ -7,6 +7,37 @@
 #include "ReacousticSubsystemComponent.h"
 #include "ReacousticAudioComponentManager.generated.h"
 
+class UAudioComponent;
+
+/** An AudioComponent from the pool that is currently in use, together with the priority it was acquired with. */
+USTRUCT()
+struct FReacousticVoice
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Transient)
+	UAudioComponent* AudioComponent {nullptr};
+
+	/** The priority of the voice. Voices with a lower priority are stolen first. */
+	float Priority {0.0f};
+
+	/** The frame in which the voice was acquired. */
+	uint64 AcquireFrame {0};
+
+	FReacousticVoice()
+	{
+	}
+
+	FReacousticVoice(UAudioComponent* InAudioComponent, const float InPriority, const uint64 InAcquireFrame)
+		: AudioComponent(InAudioComponent)
+		, Priority(InPriority)
+		, AcquireFrame(InAcquireFrame)
+	{
+	}
+};
+
+/** Manages a fixed size pool of AudioComponents that are used to play impact sounds.
+ *	Voices are moved to the location of the impact instead of being attached to the actor that was hit. */
 UCLASS()
 class UReacousticAudioComponentManager : public UReacousticSubsystemComponent
 {
@@ -21,13 +52,43 @@ private:
 	UPROPERTY(Transient)
 	TArray<UAudioComponent*> AvailableAudioComponents;
 
-	/** Array of AudioComponent instances that are currently playing. */
+	/** Array of voices that are currently in use. */
 	UPROPERTY(Transient)
-	TArray<UAudioComponent*> ActiveAudioComponents;
+	TArray<FReacousticVoice> ActiveVoices;
 
-protected:
-	virtual void Initialize(UReacousticSubsystem* Subsystem) override;
+	/** The amount of AudioComponents in the pool. */
+	int32 PoolSize {0};
 
 public:
-	FORCEINLINE TArray<UAudioComponent*> GetActiveAudioComponents() const { return ActiveAudioComponents; }
-};
\ No newline at end of file
+	virtual void Initialize(UReacousticSubsystem* Subsystem) override;
+	virtual void Deinitialize(UReacousticSubsystem* Subsystem) override;
+
+	/** Acquires a voice from the pool. If no voice is available, the active voice with the lowest priority is stolen,
+	 *	provided that its priority is lower than the requested priority.
+	 *	@Priority The priority of the new voice. Use CalculateVoicePriority to get a priority for an impact.
+	 *	@Location The world location to move the voice to.
+	 *	@Return The acquired AudioComponent, or a nullptr if no voice could be acquired.
+	 */
+	UAudioComponent* AcquireVoice(const float Priority, const FVector& Location);
+
+	/** Stops a voice and returns it to the pool.
+	 *	Voices are released automatically when they finish playing, so this only needs to be called to stop a voice early. */
+	void ReleaseVoice(UAudioComponent* AudioComponent);
+
+	/** Returns the priority of an impact, based on the impact strength and the distance to the audio listener.
+	 *	The strength is divided by the distance to the listener in meters, so that loud nearby impacts are preferred. */
+	float CalculateVoicePriority(const float ImpactStrength, const FVector& Location) const;
+
+	/** Returns all AudioComponents that are currently in use. */
+	TArray<UAudioComponent*> GetActiveAudioComponents() const;
+
+	FORCEINLINE int32 GetActiveVoiceCount() const { return ActiveVoices.Num(); }
+	FORCEINLINE int32 GetPoolSize() const { return PoolSize; }
+
+private:
+	/** Returns voices that have stopped playing to the pool. Voices acquired during this frame are kept, as they may not have started yet. */
+	void ReclaimFinishedVoices();
+
+	/** Handles a pooled AudioComponent finishing playback. */
+	void HandleVoiceFinished(UAudioComponent* AudioComponent);
+};
@@ -6,10 +6,12 @@
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
 #include "ReacousticDataTypes.h"
+#include "ReacousticRingBuffer.h"
 #include "components/AudioComponent.h"
 #include "ReacousticComponent.generated.h"
 
 class ReacousticSoundDataRef_Map;
+class UReacousticSubsystem;
 
 UCLASS(Abstract, Blueprintable, ClassGroup = "Reacoustic", Meta = (BlueprintSpawnableComponent))
 class REACOUSTIC_API UReacousticComponent : public UActorComponent
@@ -19,16 +21,36 @@ class REACOUSTIC_API UReacousticComponent : public UActorComponent
 	DECLARE_LOG_CATEGORY_CLASS(LogReacousticComponent, Log, All)
 
 protected:
+	/** The pooled voice that was most recently acquired for this component. Voices are shared between components,
+	 *	so this is only valid to use during the hit that acquired it. */
 	UPROPERTY(Transient, BlueprintReadOnly)
 	UAudioComponent* AudioComponent {nullptr};
 
+	/** The sound that is played on pooled voices when this component is hit. */
+	UPROPERTY(Transient, BlueprintReadOnly, Meta = (DisplayName = "Impact Sound"))
+	USoundBase* ImpactSound {nullptr};
+
 	UPROPERTY(Transient, BlueprintReadWrite, Meta = (DisplayName = "Sound Data Asset"))
 	UReacousticSoundDataAsset* ReacousticSoundDataAsset {nullptr};
 
 	UPROPERTY(Transient, BlueprintReadWrite, Meta = (DisplayName = "Sound Data Asset Reference Map"))	
 	UReacousticSoundDataRef_Map* UReacousticSoundDataRefMap {nullptr};
 
-	UPROPERTY(BlueprintReadWrite)
+	/** Handle to the sound data of this component in ReacousticSoundDataAsset. Components share the sound data of the asset instead of holding a copy. */
+	UPROPERTY(Transient, BlueprintReadOnly, Meta = (DisplayName = "Sound Data Handle"))
+	FReacousticSoundDataHandle SoundDataHandle;
+
+	/** Handle to the sound data of the physical surface that was hit by the most recent impact. Invalid if the surface is not mapped or surface audio is disabled. */
+	UPROPERTY(Transient, BlueprintReadOnly, Meta = (DisplayName = "Surface Sound Data Handle"))
+	FReacousticSoundDataHandle SurfaceSoundDataHandle;
+
+	/** Sound data that was transferred to this component directly instead of through a handle. */
+	TSharedPtr<const FReacousticSoundData> CustomSoundData;
+
+	/** Kept so that existing blueprints that get or set Mesh Audio Data keep compiling. Reads and writes go through GetMeshAudioData and SetMeshAudioData,
+	 *	so this struct itself is always empty. */
+	UPROPERTY(Transient, BlueprintGetter = GetMeshAudioData, BlueprintSetter = SetMeshAudioData,
+		Meta = (DisplayName = "Mesh Audio Data", DeprecatedProperty, DeprecationMessage = "Use Get Mesh Audio Data and Transfer Data Handle instead."))
 	FReacousticSoundData MeshAudioData;
 	
 	/** Used to choose the impact sound during a hit.*/
@@ -54,12 +76,30 @@ private:
 	FVector LatestRightVector;
 	FVector LatestUpVector;
 	
-	TArray<float> DeltaStateArray;
+	/** The amount of hit states that are allowed before the state history sum is used to reject hits. */
+	static constexpr int32 DeltaStateHistoryLength {20};
+
+	/** History of hit states. Holds one more element than DeltaStateHistoryLength, so that a new hit is judged together with the full history. */
+	TReacousticRingBuffer<float, DeltaStateHistoryLength + 1> DeltaStateArray;
 	
-	/** Array used to store the latest hit values so that we can prevent multiple triggers of the same sound.*/
-	UPROPERTY(BlueprintReadOnly, Meta = (DisplayName = "Latest Hit Results", AllowPrivateAccess = "true"))
+	/** Ring buffer used to store the latest hit values so that we can prevent multiple triggers of the same sound.*/
+	TReacousticRingBuffer<float, 10> LatestMatchingElementBuffer;
+
+	/** The latest hit values as exposed to blueprints. Blueprint reads go through GetLatestMatchingElements,
+	 *	which copies them from LatestMatchingElementBuffer, so this array itself is not updated. */
+	UPROPERTY(BlueprintGetter = GetLatestMatchingElements, Meta = (DisplayName = "Latest Hit Results", AllowPrivateAccess = "true"))
 	TArray<float> LatestMatchingElements;
 
+	/** The timestamp of the onset that was chosen for the most recent impact, or a negative value if no onset was chosen. */
+	float LatestOnsetTimestamp {-1.0f};
+
+	/** Whether the hit notifications of the mesh are managed based on the sleep state of its body. */
+	bool ManagesHitNotifications {false};
+
+	/** The hit notification state that was last requested. Hit notifications are only changed when this changes,
+	 *	so that other systems that temporarily disable them, such as grabbing, are not overridden every update. */
+	bool WantsHitNotifications {true};
+
 public:	
 	UReacousticComponent();
 	
@@ -79,6 +119,14 @@ public:
 	
 	UFUNCTION(BlueprintNativeEvent, Category = Default, Meta = (DisplayName = "Trigger manual hit"))
 	void TriggerManualHit(float HitStrength);
+
+	/** Acquires a pooled voice from the subsystem, moves it to the specified location and prepares it to play this component's impact sound.
+	 *	The voice is stored in AudioComponent. Returns a nullptr if all voices are in use by impacts with a higher priority.
+	 *	@ImpactStrength The strength of the impact, used to prioritize voices.
+	 *	@Location The world location of the impact.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Reacoustic", Meta = (DisplayName = "Acquire Impact Voice"))
+	UAudioComponent* AcquireImpactVoice(float ImpactStrength, const FVector& Location);
 	
 	UFUNCTION(BlueprintNativeEvent, BlueprintCallable)
 	void OnComponentHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
@@ -94,17 +142,89 @@ public:
 	/** Get the location interval between hits */
 	UFUNCTION(BlueprintPure)
 	double ReturnDeltaLocationDistance();
+
+	/** Returns the timestamps of the most recently used onsets, ordered from oldest to newest. */
+	UFUNCTION(BlueprintGetter)
+	FORCEINLINE TArray<float> GetLatestMatchingElements() const { return LatestMatchingElementBuffer.ToArray(); }
 	
+	/** Transfers a copy of custom sound data to this component. Prefer TransferDataHandle for sound data that is stored in the sound data asset. */
 	UFUNCTION()
-	void TransferData(UReacousticSoundDataAsset* SoundDataArray, UReacousticSoundDataRef_Map* ReferenceMap, FReacousticSoundData MeshSoundDataIn);
+	void TransferData(UReacousticSoundDataAsset* SoundDataArray, UReacousticSoundDataRef_Map* ReferenceMap, const FReacousticSoundData& MeshSoundDataIn);
+
+	/** Makes this component use the sound data in the sound data asset that the handle refers to. */
+	UFUNCTION(BlueprintCallable, Category = "Reacoustic", Meta = (DisplayName = "Transfer Data Handle"))
+	void TransferDataHandle(UReacousticSoundDataAsset* SoundDataArray, UReacousticSoundDataRef_Map* ReferenceMap, FReacousticSoundDataHandle Handle);
+
+	/** Returns the sound data of this component, or a nullptr if no sound data was transferred. */
+	const FReacousticSoundData* GetSoundData() const;
+
+	/** Returns the sound data of the physical surface that was hit by the most recent impact, or a nullptr if there is none. */
+	const FReacousticSoundData* GetSurfaceSoundData() const;
+
+	/** Returns a copy of the sound data of this component. */
+	UFUNCTION(BlueprintGetter, Category = "Reacoustic", Meta = (DisplayName = "Get Mesh Audio Data"))
+	FReacousticSoundData GetMeshAudioData() const;
+
+	/** Makes this component use a copy of custom sound data, the same as TransferData without changing the assets. */
+	UFUNCTION(BlueprintSetter, Category = "Reacoustic", Meta = (DisplayName = "Set Mesh Audio Data"))
+	void SetMeshAudioData(const FReacousticSoundData& SoundData);
+
+	/** Requests the impact wave of this component's sound data to be loaded, and keeps it loaded while the component is being hit.
+	 *	@Return Whether the wave is loaded and can be played. Sound data without an impact wave is always ready. */
+	bool RequestImpactWave() const;
+
+	/** Returns whether an impact at a location can be heard by a listener, based on the attenuation of this component's sound data.
+	 *	Sound data without attenuation is audible at any distance. */
+	bool IsAudibleFrom(const FVector& ListenerLocation, const FVector& Location) const;
+
+	/** Enables hit notifications of the mesh while its body is awake and either moving faster than a threshold or near the listener, and disables them otherwise.
+	 *	Called periodically by the subsystem when sleep aware hit notifications are enabled. */
+	void UpdateHitNotifications(const bool HasListener, const FVector& ListenerLocation, const float SpeedThresholdSquared, const float ListenerRadiusSquared);
 
-	bool FilterImpact(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp,
-	                  FVector NormalImpulse, const FHitResult& Hit);
+	/** Returns the timestamp of the onset that was chosen for the most recent impact, or a negative value if no onset was chosen. */
+	FORCEINLINE float GetLatestOnsetTimestamp() const { return LatestOnsetTimestamp; }
+
+	/** Returns the amount of memory in bytes that this component uses for its sound data. Sound data shared through a handle is not included. */
+	SIZE_T GetSoundDataMemoryUsage() const;
+
+	/** Returns whether this component shares the sound data of the sound data asset instead of holding its own copy. */
+	FORCEINLINE bool UsesSharedSoundData() const { return !CustomSoundData && SoundDataHandle.IsValid(); }
+
+	/** Filters an impact against the hit history of this component, to prevent sounds from playing in unwanted situations
+	 *	such as an object glitching behind a wall. Also stores the impact strength in ImpactForce.
+	 *	@ImpactStrength The strength of the impact. See CalculateImpactStrength.
+	 *	@Hit The hit result of the impact.
+	 *	@Return Whether the impact should produce a sound.
+	 */
+	bool FilterImpact(const float ImpactStrength, const FHitResult& Hit);
+
+	/** Acquires a voice for an impact that passed the filter, and calls OnComponentHit if one could be acquired.
+	 *	If surface audio is enabled, the sound data of the surface that was hit is blended in, and the impact strength is dampened by its SurfaceDampeningPercentage.
+	 *	@Return Whether a voice was started for the impact.
+	 */
+	bool PlayImpact(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, const FVector& NormalImpulse, const FHitResult& Hit);
+
+	/** Calculates the strength of an impact from its normal impulse and the relative velocity of the two bodies. */
+	static float CalculateImpactStrength(const FVector& NormalImpulse, const FVector& RelativeVelocity);
+
+	/** Impacts weaker than this are ignored. */
+	static constexpr float MinimumImpactStrength {30.0f};
 
 	UFUNCTION(BlueprintCallable)
-	int FindTimeStampEntry(FReacousticSoundData SoundData, float ImpactValue);
+	int FindTimeStampEntry(const FReacousticSoundData& SoundData, float ImpactValue);
+
+	/** Finds the timestamp of the onset with a volume closest to the impact value, skipping onsets that were used recently.
+	 *	@Return The timestamp in seconds, or a negative value if no suitable onset was found.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Reacoustic", Meta = (DisplayName = "Find Onset Timestamp"))
+	float FindOnsetTimestamp(const FReacousticSoundData& SoundData, float ImpactValue);
 
 
+private:
+	/** The subsystem this component is registered to. */
+	UPROPERTY(Transient)
+	UReacousticSubsystem* OwningSubsystem {nullptr};
+
 protected:
 	virtual void BeginPlay() override;
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
@@ -114,6 +234,25 @@ protected:
 	UFUNCTION(BlueprintCallable, Category = "Reacoustic", Meta = (DisplayName = "Get Scaled Impact Value"))
 	static float CalculateImpactValue(const FVector& NormalImpulse, const UPrimitiveComponent* HitComponent, const AActor* OtherActor);
 
+	/** Returns the sound data that is mapped to the surface type of a physical material.
+	 *	@Actor Any actor in the world to look up the sound data in.
+	 *	@PhysicalMaterial The physical material that was hit.
+	 */
 	UFUNCTION(BlueprintCallable, Category = "Reacoustic", Meta = (DisplayName = "Get Surface Hit Sound"))
 	static FReacousticSoundData GetSurfaceHitSoundX(const AActor* Actor, const UPhysicalMaterial* PhysicalMaterial);
+
+private:
+	/** Resolves the surface that was hit by an impact and stores its sound data handle in SurfaceSoundDataHandle.
+	 *	Collision hits carry the physical material of the other body. For other hits, the hit component is traced to find it. */
+	void ResolveImpactSurface(const FHitResult& Hit);
+
+	/** Requests hit notifications of the mesh to be enabled or disabled. Does nothing if the request did not change,
+	 *	or if the owner has a component that manages its hit notifications itself. */
+	void SetWantsHitNotifications(const bool InWantsHitNotifications);
+
+	UFUNCTION()
+	void HandleMeshWake(UPrimitiveComponent* WakingComponent, FName BoneName);
+
+	UFUNCTION()
+	void HandleMeshSleep(UPrimitiveComponent* SleepingComponent, FName BoneName);
 };
@@ -7,8 +7,91 @@
 #include "Sound/SoundWave.h"
 #include "Sound/SoundConcurrency.h"
 #include "Sound/SoundAttenuation.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
 #include "ReacousticDataTypes.generated.h"
 
+/** The onsets of a sound sorted by volume. Used to find the onset that best matches the strength of an impact
+ *	with a binary search instead of iterating over every onset.
+ *	The onsets are stored in a compact, immutable format: volumes and timestamps are quantized to 16 bits and stored in a single blob,
+ *	with all volumes in ascending order followed by the timestamps in the same order. */
+USTRUCT()
+struct REACOUSTIC_API FReacousticOnsetIndex
+{
+	GENERATED_BODY()
+
+	/** The maximum amount of onsets that are tested around the closest match before giving up. */
+	static constexpr int32 MaxProbeCount {16};
+
+private:
+	/** The quantized onset volumes, followed by the quantized onset timestamps. */
+	TArray<uint16> QuantizedOnsets;
+
+	/** Multiplier that converts a quantized volume back to a volume. */
+	float VolumeScale {0.0f};
+
+	/** Multiplier that converts a quantized timestamp back to seconds. */
+	float TimestampScale {0.0f};
+
+public:
+	/** Rebuilds the index from an onset map of timestamps to volumes. */
+	void Build(const TMap<float, float>& OnsetDataMap);
+
+	/** Finds the onset with the volume closest to a target volume, skipping onsets that are close in time to recently used onsets.
+	 *	Only the MaxProbeCount onsets closest to the target volume are considered. This function does not allocate.
+	 *	@Volume The target volume.
+	 *	@ExcludedTimestamps Timestamps of recently used onsets.
+	 *	@ExclusionRadius Onsets within this many seconds of an excluded timestamp are skipped.
+	 *	@Return The index of the best onset, or INDEX_NONE if no onset could be found.
+	 */
+	int32 FindBestOnset(const float Volume, TArrayView<const float> ExcludedTimestamps, const float ExclusionRadius) const;
+
+	/** Serializes the onsets as a single bulk blob, so that loading is a straight memcpy. */
+	bool Serialize(FArchive& Ar);
+
+	FORCEINLINE float GetVolume(const int32 Index) const { return QuantizedOnsets[Index] * VolumeScale; }
+	FORCEINLINE float GetTimestamp(const int32 Index) const { return QuantizedOnsets[Num() + Index] * TimestampScale; }
+
+	FORCEINLINE int32 Num() const { return QuantizedOnsets.Num() / 2; }
+	FORCEINLINE bool IsEmpty() const { return QuantizedOnsets.IsEmpty(); }
+	FORCEINLINE SIZE_T GetAllocatedSize() const { return QuantizedOnsets.GetAllocatedSize(); }
+
+private:
+	/** Returns the quantized volumes in ascending order. */
+	FORCEINLINE TArrayView<const uint16> GetQuantizedVolumes() const { return TArrayView<const uint16>(QuantizedOnsets.GetData(), Num()); }
+};
+
+template<>
+struct TStructOpsTypeTraits<FReacousticOnsetIndex> : public TStructOpsTypeTraitsBase2<FReacousticOnsetIndex>
+{
+	enum
+	{
+		WithSerializer = true,
+	};
+};
+
+/** A handle to sound data in the Reacoustic sound data asset. Components hold a handle instead of a copy of the sound data. */
+USTRUCT(BlueprintType)
+struct FReacousticSoundDataHandle
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** The index of the sound data in UReacousticSoundDataAsset::AudioData. */
+	UPROPERTY(BlueprintReadOnly, VisibleAnywhere, Category = "Reacoustic Sound Data Handle")
+	int32 Index {INDEX_NONE};
+
+	FReacousticSoundDataHandle(){}
+	explicit FReacousticSoundDataHandle(const int32 InIndex) : Index(InIndex) {}
+
+	FORCEINLINE bool IsValid() const { return Index != INDEX_NONE; }
+};
+
+/** The result of an onset analysis of a single sound wave. */
+struct REACOUSTIC_API FReacousticOnsetAnalysis
+{
+	TArray<float> Timestamps;
+	TArray<float> Strengths;
+};
+
 USTRUCT(BlueprintType)
 struct FReacousticSoundData
 {
@@ -23,20 +106,28 @@ struct FReacousticSoundData
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = ReacousticSoundData)
 	float ImpulseLength{1.5};
 
-	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = Analysis)
+#if WITH_EDITORONLY_DATA
+	/** The uncompressed onset analysis. Only available in the editor, cooked sound data only contains OnsetIndex. */
+	UPROPERTY(EditAnywhere, Category = Analysis)
 	TArray<float> OnsetTimingData;
 
-	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = Analysis)
+	UPROPERTY(EditAnywhere, Category = Analysis)
 	TMap<float, float> OnsetDataMap;
 
-	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = Analysis)
+	UPROPERTY(EditAnywhere, Category = Analysis)
 	TArray<float> OnsetVolumeData;
 
+	/** Hash of the impact wave content and the analysis settings that the onset data was generated with. Zero if the onset data was not generated. */
+	UPROPERTY(VisibleAnywhere, Category = Analysis)
+	uint32 OnsetAnalysisHash {0};
+#endif
+
+	/** Soft references, so that the waves are only loaded for props near the listener. See UReacousticSoundStreamingManager. */
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = Sounds)
-	USoundWave* ImpactWaveAsset {nullptr};
+	TSoftObjectPtr<USoundWave> ImpactWaveAsset;
 
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = Sounds)
-	USoundWave* SlidingWaveAsset {nullptr};
+	TSoftObjectPtr<USoundWave> SlidingWaveAsset;
 
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = Surface, Meta = (ClampMin = "0.0", ClampMax = "100.0", UIMin = "0.0", UIMax = "100.0"))
 	float SurfaceDampeningPercentage{0.0};
@@ -50,9 +141,36 @@ struct FReacousticSoundData
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = ReacousticSoundData)
 	float SoundSenseVolume{10.0f};
 
-	
+	/** Compact onset lookup index built from OnsetDataMap. Generated together with the onset data and serialized with the sound data asset.
+	 *	Cooked sound data only contains this index, see UReacousticSoundDataAsset::Serialize. */
+	UPROPERTY()
+	mutable FReacousticOnsetIndex OnsetIndex;
 
 	FReacousticSoundData(){}
+
+	/** Returns the amount of memory in bytes used by this sound data, including its onset data. */
+	SIZE_T GetMemoryUsage() const
+	{
+#if WITH_EDITORONLY_DATA
+		return sizeof(FReacousticSoundData) + OnsetTimingData.GetAllocatedSize() + OnsetDataMap.GetAllocatedSize()
+			+ OnsetVolumeData.GetAllocatedSize() + OnsetIndex.GetAllocatedSize();
+#else
+		return sizeof(FReacousticSoundData) + OnsetIndex.GetAllocatedSize();
+#endif
+	}
+
+	/** Returns the onset index for this sound. In the editor, the index is rebuilt if the onset map has changed in size.
+	 *	Sound data without an onset map, such as cooked sound data, always uses the serialized index. */
+	const FReacousticOnsetIndex& GetOnsetIndex() const
+	{
+#if WITH_EDITORONLY_DATA
+		if (!OnsetDataMap.IsEmpty() && OnsetIndex.Num() != OnsetDataMap.Num())
+		{
+			OnsetIndex.Build(OnsetDataMap);
+		}
+#endif
+		return OnsetIndex;
+	}
 	
 };
 
@@ -65,7 +183,37 @@ public:
 
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = ReacousticSoundData)
 	TArray<FReacousticSoundData> AudioData;
-	
+
+	/** Returns the sound data a handle refers to, or a nullptr if the handle is invalid. */
+	FORCEINLINE const FReacousticSoundData* Find(const FReacousticSoundDataHandle Handle) const
+	{
+		return AudioData.IsValidIndex(Handle.Index) ? &AudioData[Handle.Index] : nullptr;
+	}
+
+	/** Brings every onset index up to date when cooking. The uncompressed onset data is editor only data, so cooked sound data only contains the compact onset index. */
+	virtual void Serialize(FArchive& Ar) override;
+};
+
+/** Blueprint access to the soft wave references of sound data. Blueprints that used the waves as hard references resolve them through these. */
+UCLASS()
+class REACOUSTIC_API UReacousticSoundDataLibrary : public UBlueprintFunctionLibrary
+{
+	GENERATED_BODY()
+
+public:
+	/** Returns the impact wave of sound data, and loads it if it is not loaded yet. */
+	UFUNCTION(BlueprintCallable, Category = "Reacoustic", Meta = (DisplayName = "Get Impact Wave"))
+	static USoundWave* GetImpactWave(const FReacousticSoundData& SoundData);
+
+	/** Returns the sliding wave of sound data, and loads it if it is not loaded yet. */
+	UFUNCTION(BlueprintCallable, Category = "Reacoustic", Meta = (DisplayName = "Get Sliding Wave"))
+	static USoundWave* GetSlidingWave(const FReacousticSoundData& SoundData);
+
+	UFUNCTION(BlueprintCallable, Category = "Reacoustic", Meta = (DisplayName = "Set Impact Wave"))
+	static void SetImpactWave(UPARAM(ref) FReacousticSoundData& SoundData, USoundWave* SoundWave);
+
+	UFUNCTION(BlueprintCallable, Category = "Reacoustic", Meta = (DisplayName = "Set Sliding Wave"))
+	static void SetSlidingWave(UPARAM(ref) FReacousticSoundData& SoundData, USoundWave* SoundWave);
 };
 
 USTRUCT(BlueprintType)
@@ -106,6 +254,35 @@ public:
 	TArray<FPhysicalMaterialToAudioMapEntry> PhysicalMaterialMapEntries;
 };
 
+/** Impact statistics of the Reacoustic subsystem for a single frame. */
+USTRUCT(BlueprintType)
+struct FReacousticImpactStats
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** The amount of hit events received from physics. */
+	UPROPERTY(BlueprintReadOnly, Category = "Reacoustic Impact Stats")
+	int32 EventsReceived {0};
+
+	/** The amount of hit events that were discarded by the filter pass. */
+	UPROPERTY(BlueprintReadOnly, Category = "Reacoustic Impact Stats")
+	int32 EventsCulled {0};
+
+	/** The amount of impact voices that were started. */
+	UPROPERTY(BlueprintReadOnly, Category = "Reacoustic Impact Stats")
+	int32 VoicesStarted {0};
+
+	/** The amount of impacts that were discarded because they were outside the audible radius of the listener. Included in EventsCulled. */
+	UPROPERTY(BlueprintReadOnly, Category = "Reacoustic Impact Stats")
+	int32 EventsCulledByDistance {0};
+
+	/** The amount of impacts that were merged into a nearby impact of the same or a previous frame. Included in EventsCulled. */
+	UPROPERTY(BlueprintReadOnly, Category = "Reacoustic Impact Stats")
+	int32 EventsMerged {0};
+
+	FReacousticImpactStats(){}
+};
+
 USTRUCT(BlueprintType)
 struct FReacousticObjects
 {
@@ -0,0 +1,23 @@
+// Copyright (c) 2022-present Nino Saglia. All Rights Reserved.
+// Written by Nino Saglia.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ReacousticGenerateDataCommandlet.generated.h"
+
+/** Generates the Reacoustic runtime data headlessly and saves the generated assets, e.g. as a step before cooking.
+ *	Usage: UnrealEditor-Cmd <Project>.uproject -run=ReacousticGenerateData */
+UCLASS()
+class UReacousticGenerateDataCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+	DECLARE_LOG_CATEGORY_CLASS(LogReacousticGenerateDataCommandlet, Log, All)
+
+public:
+	UReacousticGenerateDataCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
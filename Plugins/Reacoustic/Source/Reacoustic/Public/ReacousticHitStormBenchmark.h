@@ -0,0 +1,89 @@
+// Copyright (c) 2022-present Nino Saglia. All Rights Reserved.
+// Written by Nino Saglia.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReacousticDataTypes.h"
+#include "ReacousticSubsystemComponent.h"
+#include "ReacousticHitStormBenchmark.generated.h"
+
+/** Spawns a deterministic stack of physics props with Reacoustic components that collapses onto itself, and records the impact statistics of every frame.
+ *	When the benchmark finishes, the props are destroyed and a CSV report is written to Saved/Reacoustic.
+ *	Run headless with: UnrealEditor-Cmd <Project>.uproject <Map> -game -nullrhi -nosound -benchmark -fps=60 -ExecCmds="Reacoustic.HitStormBenchmark 500 600"
+ *	Add -ReacousticExitAfterBenchmark to quit when the report has been written.
+ *	The Reacoustic.Performance.HitStorm automation test runs the same benchmark and checks its summary against a budget. */
+UCLASS()
+class UReacousticHitStormBenchmark : public UReacousticSubsystemComponent
+{
+	GENERATED_BODY()
+
+	DECLARE_LOG_CATEGORY_CLASS(LogReacousticHitStormBenchmark, Log, All)
+
+	/** The statistics of a single benchmark frame. */
+	struct FFrameRecord
+	{
+		float DeltaTime {0.0f};
+		FReacousticImpactStats ImpactStats;
+		int32 ActiveVoices {0};
+		double ImpactProcessTime {0.0};
+	};
+
+private:
+	/** The props spawned for the benchmark. */
+	UPROPERTY(Transient)
+	TArray<AActor*> Props;
+
+	TArray<FFrameRecord> FrameRecords;
+
+	/** The amount of frames to record. */
+	int32 FrameCount {0};
+
+	/** The time in seconds it took to spawn the props and add their components. */
+	double PopulationTime {0.0};
+
+	/** The path of the last written report, or an empty string if no report has been written. */
+	FString ReportPath;
+
+public:
+	/** The totals of all recorded frames. */
+	struct FSummary
+	{
+		int64 EventsReceived {0};
+		int64 VoicesStarted {0};
+		double AverageImpactProcessTime {0.0};
+		double MaxImpactProcessTime {0.0};
+	};
+
+	/** Spawns the props and starts recording.
+	 *	@PropCount The amount of props to spawn.
+	 *	@InFrameCount The amount of frames to record.
+	 *	@Return False if the benchmark could not be started.
+	 */
+	bool Start(const int32 PropCount, const int32 InFrameCount);
+
+	/** Records the statistics of the last processed frame. Finishes the benchmark once all frames have been recorded. */
+	void Tick(const float DeltaTime);
+
+	/** Destroys the props and writes the report. */
+	void Finish();
+
+	FORCEINLINE bool IsRunning() const { return FrameCount > 0; }
+
+	/** Returns the amount of frames recorded by the running or last finished benchmark. */
+	FORCEINLINE int32 GetRecordedFrameCount() const { return FrameRecords.Num(); }
+
+	/** Returns the path of the report of the last finished benchmark, or an empty string if it could not be written. */
+	FORCEINLINE const FString& GetReportPath() const { return ReportPath; }
+
+	/** Returns the totals of the frames recorded by the running or last finished benchmark. */
+	FSummary GetSummary() const;
+
+private:
+	/** Spawns the props in a stack in front of the listener, with a deterministic offset and rotation per prop so that the stack collapses. */
+	void SpawnProps(const int32 PropCount, TSubclassOf<class UReacousticComponent> ComponentClass);
+
+	/** Writes the recorded frames as CSV and logs a summary.
+	 *	@Return The path of the report, or an empty string if it could not be written. */
+	FString WriteReport() const;
+};
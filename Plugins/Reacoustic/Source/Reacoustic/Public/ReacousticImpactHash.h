@@ -0,0 +1,84 @@
+// Copyright (c) 2022-present Nino Saglia. All Rights Reserved.
+// Written by Nino Saglia.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** An impact that was accepted by the merge pass of the Reacoustic subsystem. */
+struct FReacousticRecentImpact
+{
+	/** The unordered pair of bodies that collided. See FReacousticImpactHash::MakePairKey. */
+	uint64 PairKey {0};
+
+	/** The world location of the impact. */
+	FVector Location {FVector::ZeroVector};
+
+	/** The world time of the impact in seconds. */
+	double Time {0.0};
+
+	/** The strength of the impact, including the strengths of the impacts that were merged into it during the same frame. */
+	float Strength {0.0f};
+
+	/** The index of the impact in the impact queue, or INDEX_NONE if the impact was queued during a previous frame. */
+	int32 QueueIndex {INDEX_NONE};
+};
+
+/** Spatial hash of the impacts accepted during a short time window, shared by all Reacoustic components.
+ *	When two props collide, both components receive a hit, and a collapsing stack produces many hits at nearly the same place and time.
+ *	Impacts are bucketed in cubic cells the size of the merge radius, and are also looked up by the pair of bodies that collided,
+ *	so that a new impact can be matched against the recent impacts of the same pair, or of any pair within the merge radius. */
+class REACOUSTIC_API FReacousticImpactHash
+{
+private:
+	/** Impacts accepted within the time window. */
+	TArray<FReacousticRecentImpact> Impacts;
+
+	/** Indices into Impacts, bucketed by cell. */
+	TMap<FIntVector, TArray<int32, TInlineAllocator<4>>> Cells;
+
+	/** Indices into Impacts, keyed by the pair of bodies that collided. */
+	TMap<uint64, int32> Pairs;
+
+	float MergeRadius {50.0f};
+	double InverseCellSize {1.0 / 50.0};
+	double TimeWindow {0.08};
+
+public:
+	/** Sets the distance and time window within which impacts are merged. Clears all recent impacts if the radius changed. */
+	void Configure(const float InMergeRadius, const double InTimeWindow);
+
+	/** Removes the impacts that are older than the time window, and marks the remaining impacts as queued during a previous frame.
+	 *	Call once per frame before matching the impacts of that frame. */
+	void BeginFrame(const double Time);
+
+	/** Finds a recent impact of the same pair of bodies within the merge radius, or otherwise the nearest recent impact within the merge radius.
+	 *	@Return The index of the matching impact, or INDEX_NONE if there is none. */
+	int32 FindMatch(const uint64 PairKey, const FVector& Location) const;
+
+	/** Adds an accepted impact. */
+	void Add(const uint64 PairKey, const FVector& Location, const double Time, const float Strength, const int32 QueueIndex);
+
+	/** Updates the strength, time and queue index of a recent impact, after an impact was merged into it or replaced it.
+	 *	The location is kept, so that the impact stays in its cell. */
+	void Update(const int32 Index, const double Time, const float Strength, const int32 QueueIndex);
+
+	/** Removes all recent impacts. */
+	void Reset();
+
+	FORCEINLINE const FReacousticRecentImpact& operator[](const int32 Index) const { return Impacts[Index]; }
+	FORCEINLINE int32 Num() const { return Impacts.Num(); }
+
+	/** Returns a key for a pair of colliding objects, which is identical regardless of which of the two objects received the hit. */
+	static uint64 MakePairKey(const UObject* A, const UObject* B);
+
+	/** Returns the combined strength of two impacts that are merged into one.
+	 *	The impacts are summed as uncorrelated sources, so two equal impacts become 3 dB louder instead of twice as loud. */
+	static FORCEINLINE float CombineStrengths(const float A, const float B) { return FMath::Sqrt(FMath::Square(A) + FMath::Square(B)); }
+
+private:
+	FORCEINLINE FIntVector GetCell(const FVector& Location) const
+	{
+		return FIntVector(FMath::FloorToInt(Location.X * InverseCellSize), FMath::FloorToInt(Location.Y * InverseCellSize), FMath::FloorToInt(Location.Z * InverseCellSize));
+	}
+};
@@ -0,0 +1,113 @@
+// Copyright (c) 2022-present Nino Saglia. All Rights Reserved.
+// Written by Nino Saglia.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/HitResult.h"
+
+class UReacousticComponent;
+
+/** The normal impulses and relative velocities of queued hit events, stored as separate float arrays per axis,
+ *	so that the impact strengths of all hits can be calculated four at a time. */
+struct REACOUSTIC_API FReacousticImpactKinematics
+{
+	TArray<float> ImpulseX;
+	TArray<float> ImpulseY;
+	TArray<float> ImpulseZ;
+	TArray<float> VelocityX;
+	TArray<float> VelocityY;
+	TArray<float> VelocityZ;
+
+	FORCEINLINE int32 Num() const { return ImpulseX.Num(); }
+
+	void Add(const FVector& NormalImpulse, const FVector& RelativeVelocity)
+	{
+		ImpulseX.Add(NormalImpulse.X);
+		ImpulseY.Add(NormalImpulse.Y);
+		ImpulseZ.Add(NormalImpulse.Z);
+		VelocityX.Add(RelativeVelocity.X);
+		VelocityY.Add(RelativeVelocity.Y);
+		VelocityZ.Add(RelativeVelocity.Z);
+	}
+
+	void Reset()
+	{
+		ImpulseX.Reset();
+		ImpulseY.Reset();
+		ImpulseZ.Reset();
+		VelocityX.Reset();
+		VelocityY.Reset();
+		VelocityZ.Reset();
+	}
+
+	/** Calculates the impact strengths of all hits with vector instructions. Gives the same result as UReacousticComponent::CalculateImpactStrength.
+	 *	@OutStrengths Receives one strength per hit. Must hold at least Num elements. */
+	void CalculateStrengths(TArrayView<float> OutStrengths) const;
+
+	/** Calculates the impact strengths of all hits one at a time with UReacousticComponent::CalculateImpactStrength. Used as a reference for CalculateStrengths. */
+	void CalculateStrengthsScalar(TArrayView<float> OutStrengths) const;
+};
+
+/** Raw hit events collected by the Reacoustic subsystem during a frame.
+ *	The events are stored as a structure of arrays, so that the batched filter pass only touches the data it needs.
+ *	The arrays are reset every frame without freeing their memory. */
+struct FReacousticImpactQueue
+{
+	/** The Reacoustic component that received the hit. */
+	TArray<TWeakObjectPtr<UReacousticComponent>> Components;
+
+	/** The component that was hit. */
+	TArray<TWeakObjectPtr<UPrimitiveComponent>> HitComponents;
+
+	/** The actor that hit the component. */
+	TArray<TWeakObjectPtr<AActor>> OtherActors;
+
+	/** The component that hit the component. */
+	TArray<TWeakObjectPtr<UPrimitiveComponent>> OtherComponents;
+
+	/** The normal impulse of the hit. */
+	TArray<FVector> NormalImpulses;
+
+	/** The normal impulses and the velocities of the hit components relative to the other actors at the time of the hits. */
+	FReacousticImpactKinematics Kinematics;
+
+	/** The world location of the impact. */
+	TArray<FVector> Locations;
+
+	/** The impact strength, calculated during the batched filter pass. */
+	TArray<float> Strengths;
+
+	/** The full hit result. Only read for impacts that survive the filter pass. */
+	TArray<FHitResult> HitResults;
+
+	FORCEINLINE int32 Num() const { return Components.Num(); }
+	FORCEINLINE bool IsEmpty() const { return Components.IsEmpty(); }
+
+	int32 Add(UReacousticComponent* Component, UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComponent,
+		const FVector& NormalImpulse, const FVector& RelativeVelocity, const FHitResult& Hit)
+	{
+		Components.Add(Component);
+		HitComponents.Add(HitComponent);
+		OtherActors.Add(OtherActor);
+		OtherComponents.Add(OtherComponent);
+		NormalImpulses.Add(NormalImpulse);
+		Kinematics.Add(NormalImpulse, RelativeVelocity);
+		Locations.Add(Hit.ImpactPoint);
+		Strengths.Add(0.0f);
+		return HitResults.Add(Hit);
+	}
+
+	void Reset()
+	{
+		Components.Reset();
+		HitComponents.Reset();
+		OtherActors.Reset();
+		OtherComponents.Reset();
+		NormalImpulses.Reset();
+		Kinematics.Reset();
+		Locations.Reset();
+		Strengths.Reset();
+		HitResults.Reset();
+	}
+};
@@ -0,0 +1,49 @@
+// Copyright (c) 2022-present Nino Saglia. All Rights Reserved.
+// Written by Nino Saglia.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/AssetUserData.h"
+#include "ReacousticLevelManifest.generated.h"
+
+class ULevel;
+class FObjectPreSaveContext;
+
+/** The actors of a level that are compatible with Reacoustic, precomputed when the level is cooked.
+ *	Stored as asset user data on the cooked level, so that the subsystem can populate the level without searching for compatible actors.
+ *	Levels without a manifest, such as levels played in the editor and levels that store their actors in external packages, are searched at runtime instead. */
+UCLASS()
+class REACOUSTIC_API UReacousticLevelManifest : public UAssetUserData
+{
+	GENERATED_BODY()
+
+public:
+	/** The compatible actors of the level, in the order they appear in the level. */
+	UPROPERTY()
+	TArray<AActor*> Actors;
+
+	/** Returns the manifest of a level, or a nullptr if the level has none. */
+	static const UReacousticLevelManifest* Find(const ULevel* Level);
+
+	/** Returns whether an actor is an instance of one of the classes that Reacoustic populates.
+	 *	@ActorClasses The allowed classes. An actor of a subclass of an allowed class is also allowed. */
+	static bool IsAllowedActor(const AActor* Actor, TConstArrayView<UClass*> ActorClasses);
+
+#if WITH_EDITOR
+	/** Returns whether an actor is set up to simulate physics and generate hit events, based on its saved properties.
+	 *	Unlike UReacousticSubsystem::IsReacousticCompatible, this does not require the physics state of the actor to be created. */
+	static bool IsCompatibleActor(const AActor* Actor);
+
+	/** Replaces the manifest of a level with the compatible actors it currently contains.
+	 *	Levels with actors in external packages do not receive a manifest, because those actors cannot be referenced from the level package. */
+	static void Build(ULevel* Level, TConstArrayView<UClass*> ActorClasses);
+
+	/** Removes the manifest of a level, so that it is never saved with the uncooked level. */
+	static void Remove(ULevel* Level);
+
+	/** Builds the manifest of the persistent level of a world that is being cooked, and removes it from worlds that are saved in the editor.
+	 *	Streamed levels are saved as worlds of their own, so they receive their own manifest. */
+	static void HandlePreSaveWorld(UWorld* World, FObjectPreSaveContext SaveContext);
+#endif
+};
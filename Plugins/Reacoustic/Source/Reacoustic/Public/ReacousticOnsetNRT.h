@@ -0,0 +1,26 @@
+// Copyright (c) 2022-present Nino Saglia. All Rights Reserved.
+// Written by Nino Saglia.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OnsetNRT.h"
+#include "ReacousticOnsetNRT.generated.h"
+
+/** Onset analyzer used to generate the Reacoustic runtime data.
+ *	The analysis of UOnsetNRT runs asynchronously and is only started by a property change of the analysed sound.
+ *	This analyzer starts the analysis explicitly and exposes whether it has finished, so that results are only read once they exist. */
+UCLASS(Transient)
+class REACOUSTIC_API UReacousticOnsetNRT : public UOnsetNRT
+{
+	GENERATED_BODY()
+
+public:
+#if WITH_EDITOR
+	/** Starts the analysis of a sound wave. The result is set on the game thread once the analysis task finishes. */
+	void BeginAnalysis(USoundWave* SoundWave);
+#endif
+
+	/** Returns whether the analysis has finished and produced a result. */
+	bool HasResult() const;
+};
@@ -0,0 +1,102 @@
+// Copyright (c) 2022-present Nino Saglia. All Rights Reserved.
+// Written by Nino Saglia.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Fixed capacity ring buffer with inline storage, used for the rolling hit histories of Reacoustic.
+ *	Adding an element to a full buffer overwrites the oldest element. The buffer never allocates.
+ *	For arithmetic element types, a running sum of all elements is kept so that GetSum is O(1). */
+template <typename ElementType, int32 Capacity>
+class TReacousticRingBuffer
+{
+	static_assert(Capacity > 0, "TReacousticRingBuffer requires a capacity greater than zero.");
+
+private:
+	/** The element storage. Elements [0, Count) are valid. */
+	ElementType Elements[Capacity] {};
+
+	/** The index that the next element will be written to. Once the buffer is full, this is also the index of the oldest element. */
+	int32 Head {0};
+
+	/** The amount of valid elements. */
+	int32 Count {0};
+
+	/** The sum of all valid elements. Only maintained for arithmetic element types. */
+	ElementType Sum {};
+
+public:
+	/** Adds an element, overwriting the oldest element if the buffer is full. */
+	void Add(const ElementType& Element)
+	{
+		if constexpr (TIsArithmetic<ElementType>::Value)
+		{
+			if (Count == Capacity)
+			{
+				Sum -= Elements[Head];
+			}
+			Sum += Element;
+		}
+
+		Elements[Head] = Element;
+		Head = (Head + 1) % Capacity;
+		Count = FMath::Min(Count + 1, Capacity);
+
+		/** Recalculate the sum every full cycle to prevent floating point error from accumulating. */
+		if constexpr (TIsArithmetic<ElementType>::Value)
+		{
+			if (Head == 0)
+			{
+				Sum = ElementType {};
+				for (int32 Index {0}; Index < Count; ++Index)
+				{
+					Sum += Elements[Index];
+				}
+			}
+		}
+	}
+
+	/** Removes all elements. */
+	void Reset()
+	{
+		Head = 0;
+		Count = 0;
+		Sum = ElementType {};
+	}
+
+	/** Returns the element at a position relative to the oldest element. Index 0 is the oldest element. */
+	const ElementType& operator[](const int32 Index) const
+	{
+		check(Index >= 0 && Index < Count);
+		return Elements[(Head - Count + Index + Capacity) % Capacity];
+	}
+
+	/** Returns the most recently added element. The buffer must not be empty. */
+	const ElementType& Last() const
+	{
+		check(Count > 0);
+		return Elements[(Head - 1 + Capacity) % Capacity];
+	}
+
+	/** Returns a view of all valid elements. The elements are not in insertion order. */
+	FORCEINLINE TArrayView<const ElementType> GetElementsUnordered() const { return TArrayView<const ElementType>(Elements, Count); }
+
+	/** Copies all elements to an array, ordered from oldest to newest. */
+	TArray<ElementType> ToArray() const
+	{
+		TArray<ElementType> Array;
+		Array.Reserve(Count);
+		for (int32 Index {0}; Index < Count; ++Index)
+		{
+			Array.Add((*this)[Index]);
+		}
+		return Array;
+	}
+
+	FORCEINLINE ElementType GetSum() const { return Sum; }
+	FORCEINLINE int32 Num() const { return Count; }
+	FORCEINLINE bool IsEmpty() const { return Count == 0; }
+	FORCEINLINE bool IsFull() const { return Count == Capacity; }
+	static constexpr int32 GetCapacity() { return Capacity; }
+};
@@ -7,8 +7,11 @@
 #include "ReacousticDataTypes.h"
 #include "Engine/DeveloperSettings.h"
 #include "UObject/SoftObjectPath.h"
+#include "UObject/StrongObjectPtr.h"
 #include "ReacousticSettings.generated.h"
 
+class UReacousticOnsetNRT;
+
 UCLASS(config = Reacoustic, defaultconfig, Meta = (DisplayName = "Reacoustic"))
 class REACOUSTIC_API UReacousticProjectSettings : public UDeveloperSettings
 {
@@ -30,27 +33,194 @@ public:
 	FSoftObjectPath ReacousticSurfaces;
 
 	UPROPERTY(Config, EditAnywhere, Meta = (AllowedClasses = UReacousticComponent))
-	FSoftObjectPath ReacousticComponent;
+	FSoftObjectPath ReacousticComponent {TEXT("/Reacoustic/Blueprints/BPC_ReacousticComponent.BPC_ReacousticComponent_C")};
+
+	/** When true, the subsystem adds the Reacoustic Component to all compatible actors when the world begins play, and to compatible actors in levels that are streamed in.
+	 *	Cooked levels contain a precomputed list of their compatible actors, so that they do not need to be searched at runtime. */
+	UPROPERTY(Config, EditAnywhere, Category = "Population", Meta = (DisplayName = "Auto Populate On Begin Play"))
+	bool AutoPopulateOnBeginPlay {true};
+
+	/** The actor classes that receive a Reacoustic component during population. When empty, only static mesh actors are populated. */
+	UPROPERTY(Config, EditAnywhere, Category = "Population", Meta = (DisplayName = "Auto Populate Actor Classes"))
+	TArray<TSoftClassPtr<AActor>> AutoPopulateActorClasses;
+
+	/** When true, Reacoustic components are added to the world over multiple frames instead of in a single frame.
+	 *	This prevents a hitch when populating large levels. */
+	UPROPERTY(Config, EditAnywhere, Category = "Population", Meta = (DisplayName = "Use Incremental Population"))
+	bool UseIncrementalPopulation {true};
+
+	/** The maximum time in milliseconds that may be spent adding Reacoustic components to actors each frame during incremental population.
+	 *	At least one actor is always processed per frame. */
+	UPROPERTY(Config, EditAnywhere, Category = "Population", Meta = (DisplayName = "Population Frame Budget", Units = "Milliseconds",
+		EditCondition = "UseIncrementalPopulation", ClampMin = "0.1", UIMin = "0.1", UIMax = "16.0"))
+	float PopulationFrameBudget {2.0f};
+
+	/** When true, hit notifications of Reacoustic props are only enabled while their body is awake and either moving or near the listener.
+	 *	This prevents physics from generating hit events for the resting contacts of sleeping props. */
+	UPROPERTY(Config, EditAnywhere, Category = "Hit Notifications", Meta = (DisplayName = "Use Sleep Aware Hit Notifications"))
+	bool UseSleepAwareHitNotifications {true};
+
+	/** Awake props that move faster than this keep their hit notifications enabled. */
+	UPROPERTY(Config, EditAnywhere, Category = "Hit Notifications", Meta = (DisplayName = "Hit Notification Speed Threshold", Units = "CentimetersPerSecond",
+		EditCondition = "UseSleepAwareHitNotifications", ClampMin = "0.0", UIMax = "100.0"))
+	float HitNotificationSpeedThreshold {10.0f};
+
+	/** Awake props within this distance of the listener keep their hit notifications enabled, even when moving slowly. */
+	UPROPERTY(Config, EditAnywhere, Category = "Hit Notifications", Meta = (DisplayName = "Hit Notification Listener Radius", Units = "Centimeters",
+		EditCondition = "UseSleepAwareHitNotifications", ClampMin = "0.0", UIMax = "5000.0"))
+	float HitNotificationListenerRadius {1000.0f};
+
+	/** The maximum amount of props whose hit notifications are updated each frame. Sleep and wake events are always handled immediately. */
+	UPROPERTY(Config, EditAnywhere, Category = "Hit Notifications", Meta = (DisplayName = "Hit Notification Updates Per Frame",
+		EditCondition = "UseSleepAwareHitNotifications", ClampMin = "1", UIMax = "1024"))
+	int32 HitNotificationUpdatesPerFrame {128};
+
+	/** Components that manage the hit notifications of their owner themselves, such as a component that suppresses them while a prop is held.
+	 *	The hit notifications of actors that own one of these components are left alone. */
+	UPROPERTY(Config, EditAnywhere, Category = "Hit Notifications", Meta = (DisplayName = "Hit Notification Owner Component Classes",
+		EditCondition = "UseSleepAwareHitNotifications"))
+	TArray<TSoftClassPtr<UActorComponent>> HitNotificationOwnerComponentClasses;
+
+	/** The amount of pooled AudioComponents used to play impact sounds. When all voices are in use, the voice with the lowest priority is stolen. */
+	UPROPERTY(Config, EditAnywhere, Category = "Playback", Meta = (DisplayName = "Voice Pool Size", ClampMin = "1", UIMin = "1", UIMax = "128"))
+	int32 VoicePoolSize {32};
+
+	/** When true, impacts blend the sound data of the object with the sound data of the physical surface that was hit.
+	 *	Disable to skip resolving the physical material of every impact. */
+	UPROPERTY(Config, EditAnywhere, Category = "Playback", Meta = (DisplayName = "Use Surface Audio"))
+	bool UseSurfaceAudio {true};
+
+	/** The rate at which the loops of sliding and rolling objects are updated. */
+	UPROPERTY(Config, EditAnywhere, Category = "Sliding", Meta = (DisplayName = "Sliding Update Rate", Units = "Hertz", ClampMin = "1.0", UIMin = "1.0", UIMax = "120.0"))
+	float SlidingUpdateRate {30.0f};
+
+	/** The maximum amount of sliding and rolling loops that can play at the same time. The loudest and closest loops are kept. */
+	UPROPERTY(Config, EditAnywhere, Category = "Sliding", Meta = (DisplayName = "Max Sliding Loops", ClampMin = "0", UIMax = "32"))
+	int32 MaxSlidingLoops {8};
+
+	/** The maximum amount of impacts that can play per region each frame. The loudest impacts are kept. */
+	UPROPERTY(Config, EditAnywhere, Category = "Playback", Meta = (DisplayName = "Max Impacts Per Region", ClampMin = "1", UIMin = "1", UIMax = "16"))
+	int32 MaxImpactsPerRegion {4};
+
+	/** The size of the cubic regions that impacts are grouped into when limiting the amount of impacts per frame. */
+	UPROPERTY(Config, EditAnywhere, Category = "Playback", Meta = (DisplayName = "Impact Region Size", Units = "Centimeters", ClampMin = "1.0", UIMin = "10.0"))
+	float ImpactRegionSize {200.0f};
+
+	/** When true, impacts of the same pair of bodies, or of bodies close to each other, are merged into one louder impact.
+	 *	This prevents both props of a collision, and every prop of a collapsing stack, from playing their own sound. */
+	UPROPERTY(Config, EditAnywhere, Category = "Playback", Meta = (DisplayName = "Use Impact Merging"))
+	bool UseImpactMerging {true};
+
+	/** Impacts within this distance of each other are merged, whether they are of the same pair of bodies or of different pairs. */
+	UPROPERTY(Config, EditAnywhere, Category = "Playback", Meta = (DisplayName = "Impact Merge Radius", Units = "Centimeters",
+		EditCondition = "UseImpactMerging", ClampMin = "1.0", UIMin = "1.0", UIMax = "200.0"))
+	float ImpactMergeRadius {50.0f};
+
+	/** Impacts are merged with impacts that happened up to this long ago. An impact that is louder than a matching impact of a previous frame is played as well. */
+	UPROPERTY(Config, EditAnywhere, Category = "Playback", Meta = (DisplayName = "Impact Merge Window", Units = "Seconds",
+		EditCondition = "UseImpactMerging", ClampMin = "0.0", UIMax = "0.5"))
+	float ImpactMergeWindow {0.08f};
+
+	/** When true, impact and sliding waves are only loaded for props near the listener, and are released after a period of inactivity.
+	 *	When false, the waves of every registered prop are loaded and kept loaded. */
+	UPROPERTY(Config, EditAnywhere, Category = "Streaming", Meta = (DisplayName = "Use Sound Streaming"))
+	bool UseSoundStreaming {true};
+
+	/** The waves of props within this distance of the listener are loaded ahead of their first impact. */
+	UPROPERTY(Config, EditAnywhere, Category = "Streaming", Meta = (DisplayName = "Sound Prefetch Radius", Units = "Centimeters",
+		EditCondition = "UseSoundStreaming", ClampMin = "0.0", UIMax = "10000.0"))
+	float SoundPrefetchRadius {3000.0f};
+
+	/** Waves that have not been played or prefetched for this long are released. */
+	UPROPERTY(Config, EditAnywhere, Category = "Streaming", Meta = (DisplayName = "Sound Release Delay", Units = "Seconds",
+		EditCondition = "UseSoundStreaming", ClampMin = "0.0", UIMax = "300.0"))
+	float SoundReleaseDelay {30.0f};
+
+	/** The data asset that GenerateRuntimeData writes the sound data of all objects and surfaces to. */
+	UPROPERTY(Config, EditAnywhere, Category = "Generated Data", Meta = (DisplayName = "Generated Sound Data Asset", AllowedClasses = "/Script/Reacoustic.ReacousticSoundDataAsset"))
+	FSoftObjectPath GeneratedSoundDataAsset {TEXT("/Reacoustic/GENERATED/DataAssets/ReacousticSoundDataAsset.ReacousticSoundDataAsset")};
+
+	/** The reference map that GenerateRuntimeData writes the mesh and surface references to. */
+	UPROPERTY(Config, EditAnywhere, Category = "Generated Data", Meta = (DisplayName = "Generated Sound Data Reference Map", AllowedClasses = "/Script/Reacoustic.ReacousticSoundDataRef_Map"))
+	FSoftObjectPath GeneratedSoundDataRefMap {TEXT("/Reacoustic/GENERATED/DataAssets/ReacousticSounDataRefMap.ReacousticSounDataRefMap")};
+
+	/** The channel that onsets are analysed on. */
+	static constexpr int32 OnsetAnalysisChannel {2};
+
+	/** Increment when the onset analysis changes, to invalidate all previously generated onset data. */
+	static constexpr uint32 OnsetAnalysisVersion {1};
+
+	/** The maximum time in seconds to wait for the analysis of a single sound. */
+	static constexpr float OnsetAnalysisTimeout {60.0f};
 
 protected:
-	/** The GENERATED data used by the reacoustic subsystem.#1#*/
-	UReacousticSoundDataAsset* ReacousticSoundDataAsset;
-	UReacousticSoundDataRef_Map* ReacousticSoundDataRefMap;
+	/** The GENERATED data used by the reacoustic subsystem.*/
+	UPROPERTY(Transient)
+	UReacousticSoundDataAsset* ReacousticSoundDataAsset {nullptr};
+	
+	UPROPERTY(Transient)
+	UReacousticSoundDataRef_Map* ReacousticSoundDataRefMap {nullptr};
 
+#if WITH_EDITORONLY_DATA
+	/** Onset analysis results keyed by the hash of the analysed sound wave and the analysis settings.
+	 *	Seeded from the generated sound data asset, so that unchanged sounds are never analysed twice. */
+	TMap<uint32, FReacousticOnsetAnalysis> OnsetAnalysisCache;
+#endif
 
 public:
-	/** Calls the GenerateRuntimeData function in the subsystem.*/
-	void GenerateRuntimeData();
-
-
+	FORCEINLINE UReacousticSoundDataAsset* GetReacousticSoundDataAsset() const { return ReacousticSoundDataAsset; }
+	FORCEINLINE UReacousticSoundDataRef_Map* GetReacousticSoundDataRefMap() const { return ReacousticSoundDataRefMap; }
 
+	/** Loads the actor classes that receive a Reacoustic component during population. Returns AStaticMeshActor if no classes are set. */
+	TArray<UClass*> LoadAutoPopulateActorClasses() const;
 
+	/** Loads the component classes that manage the hit notifications of their owner themselves. */
+	TArray<UClass*> LoadHitNotificationOwnerComponentClasses() const;
 
 #if WITH_EDITOR
+	/** Generates the sound data asset and reference map from the Objects and Surfaces data tables.
+	 *	Onset analysis results are cached, so only sounds that changed since the last run are analysed.
+	 *	Sounds that miss the cache are analysed concurrently in batches, after which all rows are merged into the assets in table order.
+	 *	@CanCancel Whether the user can cancel the generation from the progress dialog.
+	 *	@Return False if the generation failed or was cancelled, in which case the generated assets are left unchanged.
+	 */
+	bool GenerateRuntimeData(const bool CanCancel = true);
+
+	/** Returns a hash of the content of a sound wave and the onset analysis settings. */
+	static uint32 GetOnsetAnalysisHash(const USoundWave* SoundWave);
+
+	/** Generates the runtime data from an editor utility blueprint. See GenerateRuntimeData. */
+	UFUNCTION(BlueprintCallable, Category = "Reacoustic|Editor", Meta = (DisplayName = "Generate Reacoustic Runtime Data"))
+	static bool GenerateReacousticRuntimeData();
+
+	/** Returns the editor only onset analysis of sound data, for editor utility blueprints. */
+	UFUNCTION(BlueprintPure, Category = "Reacoustic|Editor")
+	static void GetSoundDataOnsets(const FReacousticSoundData& SoundData, TArray<float>& OnsetTimingData, TArray<float>& OnsetVolumeData, TMap<float, float>& OnsetDataMap);
+
+	/** Replaces the onset analysis of sound data, and rebuilds its onset map and onset index from it. For editor utility blueprints.
+	 *	The onsets are not tagged with an analysis hash, so the next GenerateRuntimeData analyses the sound again. */
+	UFUNCTION(BlueprintCallable, Category = "Reacoustic|Editor")
+	static void SetSoundDataOnsets(UPARAM(ref) FReacousticSoundData& SoundData, const TArray<float>& OnsetTimingData, const TArray<float>& OnsetVolumeData);
+
 	virtual FName GetCategoryName() const override { return FName(TEXT("Game")); }
 	virtual FText GetSectionText() const override { return NSLOCTEXT("ReacousticPlugin", "ReacousticSettingsSection", "Reacoustic"); };
 
 	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+
+private:
+	/** Pumps the game thread until all started analyses have finished, or until OnsetAnalysisTimeout has passed. Must be called on the game thread. */
+	static void WaitForOnsetAnalyses(TArrayView<const TStrongObjectPtr<UReacousticOnsetNRT>> OnsetNRTs);
+
+	/** Reads the onsets of a finished analysis. Must be called on the game thread.
+	 *	@Return False if the analysis did not finish or found no onsets.
+	 */
+	static bool ReadOnsetAnalysis(const UReacousticOnsetNRT* OnsetNRT, const USoundWave* SoundWave, FReacousticOnsetAnalysis& OutAnalysis);
+
+	/** Writes a cached onset analysis into sound data. */
+	static void ApplyOnsetAnalysis(const FReacousticOnsetAnalysis& Analysis, const uint32 AnalysisHash, FReacousticSoundData& SoundData);
+
+	/** Adds all onset data in the generated sound data asset to the cache. */
+	void SeedOnsetAnalysisCache();
 #endif
 	
-};
+};
\ No newline at end of file
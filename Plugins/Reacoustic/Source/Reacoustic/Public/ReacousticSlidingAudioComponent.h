@@ -7,22 +7,99 @@
 #include "Components/ActorComponent.h"
 #include "ReacousticSlidingAudioComponent.generated.h"
 
-UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
-class UReacousticSlidingAudioComponent : public UActorComponent
+class UAudioComponent;
+class UReacousticSlidingAudioManager;
+
+/** Plays a sliding or rolling loop while the physics mesh of the owner is in contact with something and moving.
+ *	The volume and pitch of the loop follow the contact velocity. This component does not tick:
+ *	all sliding components are updated together by the sliding audio manager of the Reacoustic subsystem. */
+UCLASS( ClassGroup=(Reacoustic), meta=(BlueprintSpawnableComponent) )
+class REACOUSTIC_API UReacousticSlidingAudioComponent : public UActorComponent
 {
 	GENERATED_BODY()
 
+	DECLARE_LOG_CATEGORY_CLASS(LogReacousticSlidingAudioComponent, Log, All)
+
+public:
+	/** The loop to play while sliding. When not set, the SlidingWaveAsset of the owner's Reacoustic sound data is used. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Reacoustic Sliding", Meta = (DisplayName = "Sliding Sound"))
+	USoundBase* SlidingSound {nullptr};
+
+	/** The contact speed at which the loop starts, and at which the minimum volume and pitch are used. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Reacoustic Sliding", Meta = (DisplayName = "Minimum Sliding Speed", Units = "CentimetersPerSecond", ClampMin = "0.0"))
+	float MinimumSlidingSpeed {10.0f};
+
+	/** The contact speed at which the maximum volume and pitch are used. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Reacoustic Sliding", Meta = (DisplayName = "Maximum Sliding Speed", Units = "CentimetersPerSecond", ClampMin = "0.0"))
+	float MaximumSlidingSpeed {500.0f};
+
+	/** The volume multiplier of the loop at the minimum and maximum sliding speed. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Reacoustic Sliding", Meta = (DisplayName = "Volume Range"))
+	FVector2D VolumeRange {0.1, 1.0};
+
+	/** The pitch multiplier of the loop at the minimum and maximum sliding speed. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Reacoustic Sliding", Meta = (DisplayName = "Pitch Range"))
+	FVector2D PitchRange {0.8, 1.2};
+
+	/** The time in seconds after the last contact during which the contact is considered to persist. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Reacoustic Sliding", Meta = (DisplayName = "Contact Timeout", Units = "Seconds", ClampMin = "0.0"))
+	float ContactTimeout {0.15f};
+
+private:
+	/** The physics simulating mesh of the owner. */
+	UPROPERTY(Transient)
+	UStaticMeshComponent* MeshComponent {nullptr};
+
+	/** The pooled loop that is currently assigned to this component, if any. */
+	UPROPERTY(Transient)
+	UAudioComponent* LoopAudioComponent {nullptr};
+
+	/** The manager this component is registered to. */
+	UPROPERTY(Transient)
+	UReacousticSlidingAudioManager* SlidingAudioManager {nullptr};
+
+	/** The actor the mesh was last in contact with. */
+	TWeakObjectPtr<AActor> ContactActor;
+
+	/** The normal of the last contact. */
+	FVector ContactNormal {FVector::UpVector};
+
+	/** The world time of the last contact. */
+	double LatestContactTime {-1.0};
+
 public:	
-	// Sets default values for this component's properties
 	UReacousticSlidingAudioComponent();
 
+	/** Returns the speed of the mesh along the contact surface, if the mesh is sliding or rolling.
+	 *	@CurrentTime The current world time in seconds.
+	 *	@OutSpeed The sliding speed in centimeters per second.
+	 *	@Return False if the mesh is asleep, not in contact with anything, or moving slower than MinimumSlidingSpeed.
+	 */
+	bool GetSlidingSpeed(const double CurrentTime, float& OutSpeed) const;
+
+	/** Returns the loop that is played while sliding. */
+	USoundBase* GetSlidingSound() const;
+
+	/** Starts playing a pooled loop on this component's mesh. Called by the sliding audio manager. */
+	void StartLoop(UAudioComponent* AudioComponent, const float SlidingSpeed);
+
+	/** Updates the volume and pitch of the loop from the sliding speed. Called by the sliding audio manager. */
+	void UpdateLoop(const float SlidingSpeed);
+
+	/** Stops the loop and returns it, so that the sliding audio manager can return it to the pool. */
+	UAudioComponent* StopLoop();
+
+	FORCEINLINE bool IsPlayingLoop() const { return LoopAudioComponent != nullptr; }
+	FORCEINLINE UStaticMeshComponent* GetMeshComponent() const { return MeshComponent; }
+
 protected:
-	// Called when the game starts
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
-public:	
-	// Called every frame
-	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+private:
+	UFUNCTION()
+	void HandleMeshHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
 
-		
+	UFUNCTION()
+	void HandleMeshSleep(UPrimitiveComponent* SleepingComponent, FName BoneName);
 };
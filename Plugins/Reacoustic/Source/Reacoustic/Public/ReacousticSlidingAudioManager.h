@@ -0,0 +1,70 @@
+// Copyright (c) 2022-present Nino Saglia. All Rights Reserved.
+// Written by Tim Verberne.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReacousticSubsystemComponent.h"
+#include "ReacousticSlidingAudioManager.generated.h"
+
+class UAudioComponent;
+class UReacousticSlidingAudioComponent;
+
+/** Updates all sliding audio components at a fixed rate, instead of every component ticking on its own.
+ *	Loops are played on a fixed size pool of AudioComponents. When more components are sliding than there are loops,
+ *	the loudest and closest components are heard. */
+UCLASS()
+class UReacousticSlidingAudioManager : public UReacousticSubsystemComponent
+{
+	GENERATED_BODY()
+
+	DECLARE_LOG_CATEGORY_CLASS(LogReacousticSlidingAudioManager, Log, All)
+
+	/** A sliding component that wants to play a loop during an update. */
+	struct FSlidingCandidate
+	{
+		UReacousticSlidingAudioComponent* Component {nullptr};
+		float SlidingSpeed {0.0f};
+		float Priority {0.0f};
+	};
+
+private:
+	/** All registered sliding components. */
+	UPROPERTY(Transient)
+	TArray<UReacousticSlidingAudioComponent*> SlidingComponents;
+
+	/** Pool of loop AudioComponents that are not in use. */
+	UPROPERTY(Transient)
+	TArray<UAudioComponent*> AvailableLoops;
+
+	/** Scratch array of the components that want to play a loop. Kept as a member to reuse its memory between updates. */
+	TArray<FSlidingCandidate> Candidates;
+
+	/** Time accumulated since the last update. */
+	float TimeSinceUpdate {0.0f};
+
+	/** The time between updates. */
+	float UpdateInterval {1.0f / 30.0f};
+
+	/** The maximum amount of loops that can play at the same time. */
+	int32 MaxLoops {0};
+
+public:
+	virtual void Initialize(UReacousticSubsystem* Subsystem) override;
+	virtual void Deinitialize(UReacousticSubsystem* Subsystem) override;
+
+	/** Advances the update timer, and updates all sliding components when an update is due. Called by the subsystem every frame. */
+	void Tick(const float DeltaTime);
+
+	void RegisterSlidingComponent(UReacousticSlidingAudioComponent* Component);
+	void UnregisterSlidingComponent(UReacousticSlidingAudioComponent* Component);
+
+	/** Stops the loop of a component and returns it to the pool. */
+	void ReleaseLoop(UReacousticSlidingAudioComponent* Component);
+
+	FORCEINLINE int32 GetActiveLoopCount() const { return MaxLoops - AvailableLoops.Num(); }
+
+private:
+	/** Starts, updates and stops the loops of all sliding components. */
+	void UpdateSlidingComponents();
+};
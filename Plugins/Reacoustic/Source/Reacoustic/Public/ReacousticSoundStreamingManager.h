@@ -0,0 +1,74 @@
+// Copyright (c) 2022-present Nino Saglia. All Rights Reserved.
+// Written by Tim Verberne.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReacousticSubsystemComponent.h"
+#include "ReacousticSoundStreamingManager.generated.h"
+
+struct FReacousticSoundData;
+struct FStreamableHandle;
+class USoundWave;
+
+/** Loads the impact and sliding waves of Reacoustic sound data asynchronously, and releases them when they have not been used for a while.
+ *	The waves of props within the prefetch radius of the listener, and of all mapped surfaces, are kept loaded.
+ *	When sound streaming is disabled in the project settings, waves are loaded as soon as they are needed and are never released. */
+UCLASS()
+class UReacousticSoundStreamingManager : public UReacousticSubsystemComponent
+{
+	GENERATED_BODY()
+
+	DECLARE_LOG_CATEGORY_CLASS(LogReacousticSoundStreamingManager, Log, All)
+
+	/** A wave that is loaded or being loaded. */
+	struct FStreamedWave
+	{
+		/** Keeps the wave loaded while it is valid. */
+		TSharedPtr<FStreamableHandle> Handle;
+
+		/** The world time in seconds at which the wave was last requested. */
+		double LastRequestTime {0.0};
+	};
+
+private:
+	/** All waves that are loaded or being loaded, keyed by their path. */
+	TMap<FSoftObjectPath, FStreamedWave> StreamedWaves;
+
+	/** Time accumulated since the last update. */
+	float TimeSinceUpdate {0.0f};
+
+	/** The time between prefetch updates. */
+	static constexpr float UpdateInterval {0.25f};
+
+	/** Whether waves are released after they have not been used for ReleaseDelay seconds. */
+	bool UseStreaming {true};
+
+	float PrefetchRadius {3000.0f};
+	float ReleaseDelay {30.0f};
+
+public:
+	virtual void Initialize(UReacousticSubsystem* Subsystem) override;
+	virtual void Deinitialize(UReacousticSubsystem* Subsystem) override;
+
+	/** Advances the update timer, and prefetches and releases waves when an update is due. Called by the subsystem every frame. */
+	void Tick(const float DeltaTime);
+
+	/** Requests the impact and sliding waves of sound data to be loaded, and keeps them loaded for at least another ReleaseDelay seconds. */
+	void RequestSoundData(const FReacousticSoundData& SoundData);
+
+	/** Requests a single wave to be loaded, and keeps it loaded for at least another ReleaseDelay seconds.
+	 *	@Return The wave if it is already loaded, or a nullptr if it is still loading. */
+	USoundWave* RequestWave(const TSoftObjectPtr<USoundWave>& Wave);
+
+	/** Releases all waves. Waves that are still referenced elsewhere stay loaded. */
+	void ReleaseAll();
+
+	FORCEINLINE int32 GetStreamedWaveCount() const { return StreamedWaves.Num(); }
+
+private:
+	/** Requests the waves of all props within the prefetch radius and of all mapped surfaces, and releases waves that have expired. */
+	void UpdateStreamedWaves();
+
+	double GetTime() const;
+};
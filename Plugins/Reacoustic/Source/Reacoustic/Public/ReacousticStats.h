@@ -0,0 +1,52 @@
+// Copyright (c) 2022-present Nino Saglia. All Rights Reserved.
+// Written by Nino Saglia.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+/** Use 'stat Reacoustic' to show these stats in game. */
+DECLARE_STATS_GROUP(TEXT("Reacoustic"), STATGROUP_Reacoustic, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Process Impact Queue"), STAT_ReacousticProcessImpactQueue, STATGROUP_Reacoustic, REACOUSTIC_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Process Population Queue"), STAT_ReacousticProcessPopulationQueue, STATGROUP_Reacoustic, REACOUSTIC_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Update Hit Notifications"), STAT_ReacousticUpdateHitNotifications, STATGROUP_Reacoustic, REACOUSTIC_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Update Sliding Loops"), STAT_ReacousticUpdateSlidingLoops, STATGROUP_Reacoustic, REACOUSTIC_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Hit Events Received"), STAT_ReacousticEventsReceived, STATGROUP_Reacoustic, REACOUSTIC_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Hit Events Culled"), STAT_ReacousticEventsCulled, STATGROUP_Reacoustic, REACOUSTIC_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Hit Events Culled By Distance"), STAT_ReacousticEventsCulledByDistance, STATGROUP_Reacoustic, REACOUSTIC_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Hit Events Merged"), STAT_ReacousticEventsMerged, STATGROUP_Reacoustic, REACOUSTIC_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Voices Started"), STAT_ReacousticVoicesStarted, STATGROUP_Reacoustic, REACOUSTIC_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Active Voices"), STAT_ReacousticActiveVoices, STATGROUP_Reacoustic, REACOUSTIC_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Active Sliding Loops"), STAT_ReacousticActiveSlidingLoops, STATGROUP_Reacoustic, REACOUSTIC_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Registered Components"), STAT_ReacousticRegisteredComponents, STATGROUP_Reacoustic, REACOUSTIC_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Streamed Waves"), STAT_ReacousticStreamedWaves, STATGROUP_Reacoustic, REACOUSTIC_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Population Queue"), STAT_ReacousticPopulationQueue, STATGROUP_Reacoustic, REACOUSTIC_API);
+
+/** Trace channel for per impact events. Enable with -trace=default,Reacoustic to inspect impacts in Unreal Insights. */
+UE_TRACE_CHANNEL_EXTERN(ReacousticChannel, REACOUSTIC_API);
+
+/** The outcome of a queued impact. */
+enum class EReacousticImpactDecision : uint8
+{
+	Played,
+	CulledTooWeak,
+	CulledByDistance,
+	CulledByRegion,
+	CulledByFilter,
+	CulledNoVoice,
+	CulledNotLoaded,
+	Merged,
+};
+
+/** Writes an impact event to the Reacoustic trace channel. Does nothing when the channel is disabled.
+ *	@Component The Reacoustic component that received the impact.
+ *	@Strength The strength of the impact.
+ *	@OnsetTimestamp The timestamp of the onset that was chosen for the impact, or a negative value if no onset was chosen.
+ *	@Decision What happened to the impact.
+ */
+REACOUSTIC_API void TraceReacousticImpact(const UObject* Component, const float Strength, const float OnsetTimestamp, const EReacousticImpactDecision Decision);
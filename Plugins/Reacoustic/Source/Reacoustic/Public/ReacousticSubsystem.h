@@ -6,11 +6,31 @@
 #include "ReacousticSettings.h"
 #include "CoreMinimal.h"
 #include "ReacousticDataTypes.h"
+#include "ReacousticImpactQueue.h"
+#include "ReacousticImpactHash.h"
+#include "Containers/StaticArray.h"
 #include "Subsystems/WorldSubsystem.h"
 #include "ReacousticSubsystem.generated.h"
 
+class UReacousticComponent;
+class UReacousticAudioComponentManager;
+class UReacousticSlidingAudioManager;
+class UReacousticHitStormBenchmark;
+class UReacousticSoundStreamingManager;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnReacousticPopulationCompletedDelegate, int32, ComponentCount);
+
+/** An actor that is waiting to receive a Reacoustic component. */
+struct FReacousticPopulationEntry
+{
+	TWeakObjectPtr<AActor> Actor;
+
+	/** Whether the actor is already known to be compatible, either from a level manifest or from a search. Other actors are checked before they are populated. */
+	bool IsCompatible {false};
+};
+
 UCLASS()
-class REACOUSTIC_API  UReacousticSubsystem : public UWorldSubsystem
+class REACOUSTIC_API  UReacousticSubsystem : public UTickableWorldSubsystem
 {
 	GENERATED_BODY()
 
@@ -28,6 +48,11 @@ public:
 	/** The internal reference of the global reacoustic settings.*/
 	UPROPERTY();
 	UReacousticProjectSettings* Settings;
+
+	/** Broadcast once, when all actors that were queued by the initial population have been processed.
+	 *	Actors that are spawned or streamed in afterwards receive their component without broadcasting it again. */
+	UPROPERTY(BlueprintAssignable, Category = "ReacousticSubsystem|Delegates", Meta = (DisplayName = "On Population Completed"))
+	FOnReacousticPopulationCompletedDelegate OnPopulationCompleted;
 	
 	/** Returns all actors in the level of a given class that have Physics and GenerateHitEvents enabled. This is a slow operation, and should not be called often during runtime.
 	 *	@ClassType Which class to look for in the world.
@@ -37,12 +62,112 @@ public:
 	TArray<AActor*> GetCompatibleActorsOfClass(UClass* ClassType);
 
 private:
+	/** The manager for the pooled AudioComponents that are used to play impact sounds. */
+	UPROPERTY(Transient)
+	UReacousticAudioComponentManager* AudioComponentManager {nullptr};
+
+	/** The manager that updates the loops of all sliding audio components. */
+	UPROPERTY(Transient)
+	UReacousticSlidingAudioManager* SlidingAudioManager {nullptr};
+
+	/** The manager that loads and releases the impact and sliding waves. */
+	UPROPERTY(Transient)
+	UReacousticSoundStreamingManager* SoundStreamingManager {nullptr};
+
+	/** The hit storm benchmark that is currently running, if any. */
+	UPROPERTY(Transient)
+	UReacousticHitStormBenchmark* HitStormBenchmark {nullptr};
+
 	/** Array of pointers to all currently active ReacousticComponents. */
 	TArray<class UReacousticComponent*> ReacousticComponents;
 
+	/** Lookup index from a static mesh to its sound data index in the ReacousticSoundDataAsset.
+	 *	Built from ReacousticSoundDataRefMap->MeshMapEntries and rebuilt whenever the reference map changes. */
+	mutable TMap<const UStaticMesh*, int32> MeshSoundDataIndex;
+
+	/** Lookup table from a physical surface type to its sound data index in the ReacousticSoundDataAsset. Unmapped surfaces are INDEX_NONE. */
+	mutable TStaticArray<int32, SurfaceType_Max> SurfaceSoundDataIndex {InPlace, INDEX_NONE};
+
+	/** The amount of surfaces in SurfaceSoundDataIndex that are mapped to sound data. */
+	mutable int32 MappedSurfaceCount {0};
+
+	/** The reference map the lookup indices were built from. Used to detect when the indices are stale. */
+	mutable TWeakObjectPtr<const UReacousticSoundDataRef_Map> IndexedRefMap;
+
+	/** The amount of mesh and surface entries in the reference map when the lookup indices were built. */
+	mutable int32 IndexedMeshEntryCount {INDEX_NONE};
+	mutable int32 IndexedSurfaceEntryCount {INDEX_NONE};
+
+	/** The component class that is added to actors during population. Actors spawned after population has started will receive this component as well. */
+	UPROPERTY(Transient)
+	TSubclassOf<UReacousticComponent> PopulationComponentClass;
+
+	/** The actor classes that receive a Reacoustic component during population. */
+	UPROPERTY(Transient)
+	TArray<UClass*> PopulationActorClasses;
+
+	/** Actors that are waiting to receive a Reacoustic component. */
+	TArray<FReacousticPopulationEntry> PopulationQueue;
+
+	/** The index of the next actor in the population queue to process. */
+	int32 PopulationQueueIndex {0};
+
+	/** The amount of components added since the population queue was last empty. */
+	int32 PopulatedComponentCount {0};
+
+	/** Whether the initial population has finished and OnPopulationCompleted has been broadcast. */
+	bool HasCompletedPopulation {false};
+
+	/** Whether spawned actors are currently kept out of the population queue. */
+	bool IgnoresSpawnedActors {false};
+
+	/** Handle for the actor spawned delegate of the world. */
+	FDelegateHandle ActorSpawnedDelegateHandle;
+
+	/** Handle for the level added to world delegate. */
+	FDelegateHandle LevelAddedDelegateHandle;
+
+	/** Hit events received during the current frame. */
+	FReacousticImpactQueue ImpactQueue;
+
+	/** Scratch array of queued impact indices sorted by strength. Kept as a member to reuse its memory between frames. */
+	TArray<int32> SortedImpactIndices;
+
+	/** The impacts accepted during the merge window, used to merge the impacts of colliding pairs and nearby props. */
+	FReacousticImpactHash ImpactHash;
+
+	/** Scratch map of the amount of accepted impacts per region. Kept as a member to reuse its memory between frames. */
+	TMap<FIntVector, int32> RegionImpactCounts;
+
+	/** The index of the next component in ReacousticComponents whose hit notifications will be updated. */
+	int32 HitNotificationUpdateIndex {0};
+
+	/** Component classes that manage the hit notifications of their owner themselves. Loaded from the project settings. */
+	UPROPERTY(Transient)
+	TArray<UClass*> HitNotificationOwnerComponentClasses;
+
+	/** The location of the audio listener, cached once per frame. */
+	FVector ListenerLocation {FVector::ZeroVector};
+
+	/** Whether ListenerLocation is valid for this frame. */
+	bool HasListenerLocation {false};
+
+	/** Impact statistics for the current frame. */
+	FReacousticImpactStats CurrentImpactStats;
+
+	/** Impact statistics for the last processed frame. */
+	FReacousticImpactStats LastImpactStats;
+
+	/** The time in seconds it took to process the impact queue during the last frame. */
+	double LastImpactProcessTime {0.0};
+
 public:
 	UReacousticSubsystem();
 	virtual void PostInitProperties() override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
 	void OnActorSpawned(AActor* Actor);
 
 	
@@ -62,11 +187,112 @@ public:
 	 *	@ComponentClass The reacoustic blueprint component to add.
 	 */
 	UFUNCTION(BlueprintCallable, Category = "ReacousticSubsystem")
-	void AddBPReacousticComponentToActor(AActor* Actor, TSubclassOf<UReacousticComponent> ComponentClass, FReacousticSoundData MeshSoundData);
+	UReacousticComponent* AddBPReacousticComponentToActor(AActor* Actor, TSubclassOf<UReacousticComponent> ComponentClass, const FReacousticSoundData& MeshSoundData);
+
+	/** Adds and registers a Reacoustic component that shares sound data from the sound data asset.
+	 *	@Actor The actor to add the component to.
+	 *	@ComponentClass The reacoustic blueprint component to add.
+	 *	@SoundDataHandle The sound data of the component. May be invalid.
+	 *	@Return The new component, or a nullptr if the actor already has a component of this class.
+	 */
+	UReacousticComponent* AddReacousticComponentToActor(AActor* Actor, TSubclassOf<UReacousticComponent> ComponentClass, const FReacousticSoundDataHandle SoundDataHandle);
 
-	/** Gets the sound data associated with a specific mesh.*/
-	FReacousticSoundData GetMeshSoundData(const UStaticMeshComponent* StaticMeshComponent) const;
+	/** Loads the Reacoustic component class that is set in the project settings.
+	 *	@Return The component class, or a nullptr if no valid class is set. */
+	TSubclassOf<UReacousticComponent> LoadDefaultComponentClass() const;
+
+	/** Queues a hit event to be filtered and played at the end of the frame. Called by Reacoustic components from their hit callback.
+	 *	@Component The Reacoustic component that received the hit.
+	 */
+	void QueueImpact(UReacousticComponent* Component, UPrimitiveComponent* HitComponent, AActor* OtherActor,
+		UPrimitiveComponent* OtherComponent, const FVector& NormalImpulse, const FHitResult& Hit);
+
+	/** Returns the impact statistics of the last processed frame. */
+	UFUNCTION(BlueprintPure, Category = "ReacousticSubsystem", Meta = (DisplayName = "Get Impact Stats"))
+	FORCEINLINE FReacousticImpactStats GetImpactStats() const { return LastImpactStats; }
+
+	/** Returns the time in seconds it took to filter and play the impacts of the last processed frame. */
+	FORCEINLINE double GetLastImpactProcessTime() const { return LastImpactProcessTime; }
+
+	/** Spawns a deterministic stack of physics props that collapses, and writes the impact statistics of every frame to a CSV report in Saved/Reacoustic.
+	 *	Can also be run with the Reacoustic.HitStormBenchmark console command.
+	 *	@PropCount The amount of props to spawn.
+	 *	@FrameCount The amount of frames to record.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "ReacousticSubsystem")
+	void StartHitStormBenchmark(int32 PropCount = 500, int32 FrameCount = 600);
+
+	/** Returns the hit storm benchmark, or a nullptr if no benchmark has been started. The benchmark keeps its results after it finishes. */
+	FORCEINLINE const UReacousticHitStormBenchmark* GetHitStormBenchmark() const { return HitStormBenchmark; }
+
+	/** Keeps actors that are spawned from now on out of the population queue, or stops doing so.
+	 *	Used by systems that add the Reacoustic components of the actors they spawn themselves. */
+	FORCEINLINE void SetIgnoresSpawnedActors(const bool InIgnoresSpawnedActors) { IgnoresSpawnedActors = InIgnoresSpawnedActors; }
+
+	/** Returns the location of the audio listener of the first player, cached at the start of the frame.
+	 *	@Return False if there is no audio listener. */
+	FORCEINLINE bool GetListenerLocation(FVector& OutListenerLocation) const
+	{
+		OutListenerLocation = ListenerLocation;
+		return HasListenerLocation;
+	}
+
+	/** Returns the manager for the pooled impact voices. This is a nullptr until the world has begun play. */
+	FORCEINLINE UReacousticAudioComponentManager* GetAudioComponentManager() const { return AudioComponentManager; }
+
+	/** Returns the manager for the sliding and rolling loops. This is a nullptr until the world has begun play. */
+	FORCEINLINE UReacousticSlidingAudioManager* GetSlidingAudioManager() const { return SlidingAudioManager; }
+
+	/** Returns the manager that loads and releases the impact and sliding waves. This is a nullptr until the world has begun play. */
+	FORCEINLINE UReacousticSoundStreamingManager* GetSoundStreamingManager() const { return SoundStreamingManager; }
+
+	/** Returns all registered Reacoustic components. */
+	FORCEINLINE const TArray<UReacousticComponent*>& GetReacousticComponents() const { return ReacousticComponents; }
+
+	/** Returns whether the subsystem is still adding components to queued actors. */
+	UFUNCTION(BlueprintPure, Category = "ReacousticSubsystem")
+	FORCEINLINE bool IsPopulating() const { return PopulationQueueIndex < PopulationQueue.Num(); }
+
+	/** Returns the sound data associated with the mesh of a static mesh component, or a nullptr if the mesh is not mapped. */
+	const FReacousticSoundData* FindMeshSoundData(const UStaticMeshComponent* StaticMeshComponent) const;
+
+	/** Returns a handle to the sound data associated with the mesh of a static mesh component. The handle is invalid if the mesh is not mapped. */
+	FReacousticSoundDataHandle FindMeshSoundDataHandle(const UStaticMeshComponent* StaticMeshComponent) const;
+
+	/** Returns the index in the sound data asset that is mapped to a static mesh, or INDEX_NONE if the mesh is not mapped. */
+	int32 FindMeshSoundDataIndex(const UStaticMesh* Mesh) const;
+
+	/** Returns the index in the sound data asset that is mapped to a physical surface, or INDEX_NONE if the surface is not mapped. */
+	int32 FindSurfaceSoundDataIndex(EPhysicalSurface SurfaceType) const;
+
+	/** Returns a handle to the sound data that is mapped to a physical surface. The handle is invalid if the surface is not mapped. */
+	FReacousticSoundDataHandle FindSurfaceSoundDataHandle(EPhysicalSurface SurfaceType) const;
+
+	/** Returns whether an actor owns a component that manages the hit notifications of the actor itself.
+	 *	Reacoustic components do not change the hit notifications of these actors. */
+	bool HasHitNotificationOwnerComponent(const AActor* Actor) const;
+
+	/** Returns whether impacts should blend in the sound data of the surface that was hit. */
+	FORCEINLINE bool IsSurfaceAudioEnabled() const { return Settings && Settings->UseSurfaceAudio; }
+
+	/** Rebuilds the mesh and surface lookup indices from the current sound data reference map.
+	 *	This is done automatically when the reference map is replaced or resized,
+	 *	but should be called manually after modifying existing entries of the reference map. */
+	UFUNCTION(BlueprintCallable, Category = "ReacousticSubsystem")
+	void RebuildSoundDataIndex() const;
 	
+	/** Logs the sound data memory usage of all registered components, compared to the memory they would use if every component held a copy of its sound data.
+	 *	Can also be run with the Reacoustic.MemoryReport console command. */
+	UFUNCTION(BlueprintCallable, Category = "ReacousticSubsystem")
+	void LogMemoryReport() const;
+
+	/** Compares the start-up cost of looking up sound data with a linear search of the reference map and with the lookup index,
+	 *	using a temporary reference map with generated meshes. Can also be run with the Reacoustic.BenchmarkSoundDataIndex console command.
+	 *	@MeshCount The amount of mapped meshes.
+	 *	@LookupCount The amount of lookups, one for every component that would be populated.
+	 */
+	void BenchmarkSoundDataIndex(int32 MeshCount, int32 LookupCount);
+
 	/** Checks whether an actor meets the conditions to be used by Reacoustic.
 	 *	For this, an actor must have IsSimulatingPhysics and a StaticMeshComponent with bNotifyRigidBodyCollision set to true.
 	 *	@Actor The actor to check the condition for.
@@ -76,8 +302,49 @@ public:
 	bool IsReacousticCompatible(AActor* Actor);
 
 private:
+	/** Adds a Reacoustic component to all compatible actors in the world, and to compatible actors that are spawned or streamed in afterwards.
+	 *	Called automatically when the world begins play if Auto Populate On Begin Play is enabled in the project settings.
+	 *	A world is only populated once. Calling it again does nothing, and logs a warning if a different component class is passed. */
 	UFUNCTION(BlueprintCallable)
 	void PopulateWorldWithBPReacousticComponents(TSubclassOf<UReacousticComponent> ComponentClass);
+
+	/** Queues the compatible actors of a level for population. Uses the manifest of the level if it has one, and searches the actors of the level otherwise.
+	 *	@Return The amount of queued actors. */
+	int32 QueueLevelForPopulation(const ULevel* Level);
+
+	/** Queues the compatible actors of levels that are streamed in after population has started. */
+	void OnLevelAddedToWorld(ULevel* Level, UWorld* World);
+
+	/** Loads the generated sound data asset and reference map from the project settings, unless other sound data was assigned to the subsystem. */
+	void LoadGeneratedSoundData();
+
+	/** Rebuilds the lookup indices if the sound data reference map has changed since they were last built. */
+	void UpdateSoundDataIndexIfStale() const;
+
+	/** Adds a Reacoustic component of a class to an actor, unless the actor already has one. The new component is not registered yet,
+	 *	so that sound data can be transferred to it first. */
+	UReacousticComponent* CreateReacousticComponent(AActor* Actor, TSubclassOf<UReacousticComponent> ComponentClass);
+
+	/** Adds a Reacoustic component to a single compatible actor.
+	 *	@Return The amount of components that were added. */
+	int32 PopulateActor(AActor* Actor, TSubclassOf<UReacousticComponent> ComponentClass);
+
+	/** Updates the hit notifications of a limited amount of components, continuing where the previous update left off. */
+	void UpdateHitNotifications();
+
+	/** Caches the location of the audio listener for this frame. */
+	void UpdateListenerLocation();
+
+	/** Filters all hit events queued during this frame in a single pass, and plays the loudest impacts of every region. */
+	void ProcessImpactQueue();
+
+	/** Merges the sorted impacts of this frame that match a recent impact in the impact hash.
+	 *	Impacts that match an impact of this frame make that impact louder. Impacts that match an impact of a previous frame are discarded. */
+	void MergeImpacts();
+
+	/** Processes queued actors until the queue is empty or the time budget is exceeded.
+	 *	@Budget The time budget in seconds. A value of zero or lower processes the entire queue. */
+	void ProcessPopulationQueue(double Budget);
 };
 
 
@@ -39,6 +39,7 @@ public class Reacoustic : ModuleRules
 			{
 				"CoreUObject",
 				"Engine",
+				"EngineSettings",
 				"Slate",
 				"SlateCore",
 				"InputCore", 
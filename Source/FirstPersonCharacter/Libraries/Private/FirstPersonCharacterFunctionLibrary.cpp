@@ -2,51 +2,8 @@
 // Written by Tim Verberne.
 
 #include "FirstPersonCharacterFunctionLibrary.h"
-#include "DraggableObjectInterface.h"
 #include "FirstPersonCharacterWorldSubystem.h"
-#include "GrabbableObjectInterface.h"
-#include "InteractableObjectInterface.h"
-#include "UsableObjectInterface.h"
-
-template <typename TInterface>
-UActorComponent* FindInteractableComponent(const AActor* Actor)
-{
-	if (!Actor) { return nullptr; }
-	
-	TSet<UActorComponent*> Components {Actor->GetComponents()};
-	
-	if (Components.IsEmpty()) { return nullptr; }
-	
-	for (UActorComponent* Component : Components)
-	{
-		if (Component->GetClass()->ImplementsInterface(TInterface::StaticClass()))
-		{
-			return Component;
-		}
-	}
-	return nullptr;
-}
-
-template <typename TInterface>
-UObject* FindInteractableObject(AActor* Actor)
-{
-	if (!Actor) { return nullptr; }
-	UObject* InteractableObject {nullptr};
-	
-	/** Check if the actor implements the specified interface. */
-	if (Actor->GetClass()->ImplementsInterface(TInterface::StaticClass()))
-	{
-		InteractableObject = Actor;
-	}
-	
-	/** If the actor does not implement the specified interface, try to find a component that does.*/
-	else if (UActorComponent* InteractableComponent {FindInteractableComponent<TInterface>(Actor)})
-	{
-		InteractableObject = InteractableComponent;
-	}
-	
-	return InteractableObject;
-}
+#include "InteractableObjectCache.h"
 
 UObject* UFirstPersonCharacterFunctionLibrary::SearchActorForObjectThatImplementsInterface(EFunctionResult& Result,
 	AActor* Actor, EFirstPersonCharacterInterfaceType Interface)
@@ -57,13 +14,13 @@ UObject* UFirstPersonCharacterFunctionLibrary::SearchActorForObjectThatImplement
 
 	switch(Interface)
 	{
-	case EFirstPersonCharacterInterfaceType::InteractableObject: InterfaceObject = FindInteractableObject<UInteractableObject>(Actor);
+	case EFirstPersonCharacterInterfaceType::InteractableObject: InterfaceObject = FInteractableObjectCache::FindObject<UInteractableObject>(Actor);
 		break;
-	case EFirstPersonCharacterInterfaceType::UsableObject: InterfaceObject = FindInteractableObject<UUsableObject>(Actor);
+	case EFirstPersonCharacterInterfaceType::UsableObject: InterfaceObject = FInteractableObjectCache::FindObject<UUsableObject>(Actor);
 		break;
-	case EFirstPersonCharacterInterfaceType::GrabbableObject: InterfaceObject = FindInteractableObject<UGrabbableObject>(Actor);
+	case EFirstPersonCharacterInterfaceType::GrabbableObject: InterfaceObject = FInteractableObjectCache::FindObject<UGrabbableObject>(Actor);
 		break;
-	case EFirstPersonCharacterInterfaceType::DraggableObject: InterfaceObject = FindInteractableObject<UDraggableObject>(Actor);
+	case EFirstPersonCharacterInterfaceType::DraggableObject: InterfaceObject = FInteractableObjectCache::FindObject<UDraggableObject>(Actor);
 		break;
 	default: break;
 	}
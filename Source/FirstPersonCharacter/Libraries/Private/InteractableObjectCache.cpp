@@ -0,0 +1,161 @@
+// Copyright (c) 2022-present Barrelhouse. All rights reserved.
+// Written by Nino Saglia & Tim Verberne.
+
+#include "InteractableObjectCache.h"
+#include "Engine/World.h"
+
+TMap<TObjectKey<UClass>, EInteractableInterfaceFlags> FInteractableObjectCache::ClassFlags;
+TMap<TObjectKey<AActor>, FInteractableComponentList> FInteractableObjectCache::ActorComponents;
+TMap<TObjectKey<AActor>, FInteractableActorBounds> FInteractableObjectCache::ActorBounds;
+FDelegateHandle FInteractableObjectCache::WorldCleanupDelegateHandle;
+int32 FInteractableObjectCache::ActorPruneThreshold {FInteractableObjectCache::MinActorPruneThreshold};
+
+EInteractableInterfaceFlags FInteractableObjectCache::GetClassFlags(const UClass* Class)
+{
+	check(IsInGameThread());
+	if (!Class) { return EInteractableInterfaceFlags::None; }
+
+	RegisterWorldCleanup();
+
+	if (const EInteractableInterfaceFlags* Flags {ClassFlags.Find(Class)})
+	{
+		return *Flags;
+	}
+
+	EInteractableInterfaceFlags Flags {EInteractableInterfaceFlags::None};
+	if (Class->ImplementsInterface(UInteractableObject::StaticClass())) { Flags |= EInteractableInterfaceFlags::InteractableObject; }
+	if (Class->ImplementsInterface(UUsableObject::StaticClass())) { Flags |= EInteractableInterfaceFlags::UsableObject; }
+	if (Class->ImplementsInterface(UGrabbableObject::StaticClass())) { Flags |= EInteractableInterfaceFlags::GrabbableObject; }
+	if (Class->ImplementsInterface(UDraggableObject::StaticClass())) { Flags |= EInteractableInterfaceFlags::DraggableObject; }
+
+	ClassFlags.Add(Class, Flags);
+	return Flags;
+}
+
+const FInteractableComponentList* FInteractableObjectCache::GetInteractableComponents(const AActor* Actor)
+{
+	check(IsInGameThread());
+	if (!IsValid(Actor)) { return nullptr; }
+
+	FInteractableComponentList* ExistingList {ActorComponents.Find(Actor)};
+	if (ExistingList && ExistingList->ComponentStamp.Matches(Actor))
+	{
+		return ExistingList;
+	}
+
+	if (!ExistingList)
+	{
+		PruneDestroyedActors();
+	}
+
+	FInteractableComponentList& List {ExistingList ? *ExistingList : ActorComponents.Add(Actor)};
+	List.ComponentStamp.Update(Actor);
+	List.ActorFlags = GetClassFlags(Actor->GetClass());
+	List.Components.Reset();
+	List.ComponentFlags.Reset();
+
+	for (UActorComponent* Component : Actor->GetComponents())
+	{
+		if (!Component) { continue; }
+
+		if (const EInteractableInterfaceFlags Flags {GetClassFlags(Component->GetClass())}; Flags != EInteractableInterfaceFlags::None)
+		{
+			List.Components.Add(Component);
+			List.ComponentFlags.Add(Flags);
+		}
+	}
+	return &List;
+}
+
+bool FInteractableComponentStamp::Matches(const AActor* Actor) const
+{
+	if (ComponentCount != Actor->GetComponents().Num()) { return false; }
+
+	const TArray<UActorComponent*>& ActorInstanceComponents {Actor->GetInstanceComponents()};
+	if (InstanceComponents.Num() != ActorInstanceComponents.Num()) { return false; }
+
+	for (int32 Index {0}; Index < InstanceComponents.Num(); ++Index)
+	{
+		if (InstanceComponents[Index] != TObjectKey<UActorComponent>(ActorInstanceComponents[Index])) { return false; }
+	}
+	return true;
+}
+
+void FInteractableComponentStamp::Update(const AActor* Actor)
+{
+	ComponentCount = Actor->GetComponents().Num();
+	InstanceComponents.Reset();
+	for (const UActorComponent* Component : Actor->GetInstanceComponents())
+	{
+		InstanceComponents.Add(Component);
+	}
+}
+
+float FInteractableObjectCache::GetBoundingBoxVolume(const AActor* Actor)
+{
+	check(IsInGameThread());
+	if (!IsValid(Actor)) { return 0.0f; }
+
+	RegisterWorldCleanup();
+
+	const FQuat Rotation {Actor->GetActorQuat()};
+	const FVector Scale {Actor->GetActorScale3D()};
+
+	if (!ActorBounds.Contains(Actor))
+	{
+		PruneDestroyedActors();
+	}
+
+	FInteractableActorBounds& Bounds {ActorBounds.FindOrAdd(Actor)};
+	if (Bounds.Rotation.Equals(Rotation) && Bounds.Scale.Equals(Scale) && Bounds.ComponentStamp.Matches(Actor)) { return Bounds.Volume; }
+
+	const FVector BoxExtent {Actor->GetComponentsBoundingBox(true).GetExtent()};
+	Bounds.ComponentStamp.Update(Actor);
+	Bounds.Rotation = Rotation;
+	Bounds.Scale = Scale;
+	Bounds.Volume = static_cast<float>(BoxExtent.X * BoxExtent.Y * BoxExtent.Z);
+	return Bounds.Volume;
+}
+
+void FInteractableObjectCache::PruneDestroyedActors()
+{
+	if (ActorComponents.Num() < ActorPruneThreshold && ActorBounds.Num() < ActorPruneThreshold) { return; }
+
+	for (auto Iterator {ActorComponents.CreateIterator()}; Iterator; ++Iterator)
+	{
+		if (!Iterator.Key().ResolveObjectPtr())
+		{
+			Iterator.RemoveCurrent();
+		}
+	}
+
+	for (auto Iterator {ActorBounds.CreateIterator()}; Iterator; ++Iterator)
+	{
+		if (!Iterator.Key().ResolveObjectPtr())
+		{
+			Iterator.RemoveCurrent();
+		}
+	}
+
+	/** Grow the threshold with the amount of live actors, so that pruning stays amortised constant time per added actor. */
+	ActorPruneThreshold = FMath::Max(MinActorPruneThreshold, FMath::Max(ActorComponents.Num(), ActorBounds.Num()) * 2);
+}
+
+/** The cache is emptied when a world is cleaned up, so that classes that are recompiled in the editor are evaluated again. */
+void FInteractableObjectCache::RegisterWorldCleanup()
+{
+	if (WorldCleanupDelegateHandle.IsValid()) { return; }
+
+	WorldCleanupDelegateHandle = FWorldDelegates::OnWorldCleanup.AddLambda([](UWorld*, bool, bool)
+	{
+		Reset();
+	});
+}
+
+void FInteractableObjectCache::Reset()
+{
+	ClassFlags.Reset();
+	ActorComponents.Reset();
+	ActorBounds.Reset();
+	ActorPruneThreshold = MinActorPruneThreshold;
+}
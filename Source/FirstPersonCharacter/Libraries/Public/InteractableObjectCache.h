@@ -0,0 +1,200 @@
+// Copyright (c) 2022-present Barrelhouse. All rights reserved.
+// Written by Nino Saglia & Tim Verberne.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+#include "GameFramework/Actor.h"
+#include "DraggableObjectInterface.h"
+#include "GrabbableObjectInterface.h"
+#include "InteractableObjectInterface.h"
+#include "UsableObjectInterface.h"
+
+/** Bitmask of the interaction interfaces that a class implements. */
+enum class EInteractableInterfaceFlags : uint8
+{
+	None				= 0,
+	InteractableObject	= 1 << 0,
+	UsableObject		= 1 << 1,
+	GrabbableObject		= 1 << 2,
+	DraggableObject		= 1 << 3,
+};
+ENUM_CLASS_FLAGS(EInteractableInterfaceFlags)
+
+/** Identifies the components an actor owned when a cache entry was built, without visiting every component.
+ *	Components that are added at runtime, such as through the Add Component node, are instance components,
+ *	so comparing those catches an instance component being removed and another being added between two lookups. */
+struct FInteractableComponentStamp
+{
+	/** The amount of components the actor owned. */
+	int32 ComponentCount {INDEX_NONE};
+
+	/** The instance components the actor owned, in the order in which the actor stores them. */
+	TArray<TObjectKey<UActorComponent>, TInlineAllocator<4>> InstanceComponents;
+
+	/** Returns whether the actor still owns the same components. */
+	bool Matches(const AActor* Actor) const;
+
+	/** Stores the components the actor currently owns. */
+	void Update(const AActor* Actor);
+};
+
+/** The components of an actor that implement at least one interaction interface. */
+struct FInteractableComponentList
+{
+	/** The components the actor owned when the list was built. The list is rebuilt when these change. */
+	FInteractableComponentStamp ComponentStamp;
+
+	/** The interaction interfaces implemented by the actor's class. */
+	EInteractableInterfaceFlags ActorFlags {EInteractableInterfaceFlags::None};
+
+	/** The interactable components, in the order in which the actor returns its components. */
+	TArray<TWeakObjectPtr<UActorComponent>, TInlineAllocator<4>> Components;
+
+	/** The interaction interfaces implemented by each interactable component. */
+	TArray<EInteractableInterfaceFlags, TInlineAllocator<4>> ComponentFlags;
+};
+
+/** The cached bounding box volume of an actor. */
+struct FInteractableActorBounds
+{
+	/** The components the actor owned when the volume was calculated. */
+	FInteractableComponentStamp ComponentStamp;
+
+	/** The rotation of the actor when the volume was calculated. */
+	FQuat Rotation {FQuat::Identity};
+
+	/** The scale of the actor when the volume was calculated. */
+	FVector Scale {FVector::ZeroVector};
+
+	/** The volume of the extent of the world space bounding box of the actor's components. */
+	float Volume {0.0f};
+};
+
+/** Caches which interaction interfaces classes implement, and which components of an actor implement them.
+ *	Looking up interactable objects through the cache avoids iterating all components of an actor and
+ *	calling ImplementsInterface on each of them every time the interaction target changes.
+ *	The bounding box volume of actors is cached as well, which is used to decide whether an actor is small enough to interact with directly.
+ *	Class entries are kept until the world is cleaned up, actor entries are rebuilt when a component is added to or removed from the actor,
+ *	and are removed once the actor has been destroyed.
+ *	The cache may only be accessed from the game thread. */
+class FIRSTPERSONCHARACTER_API FInteractableObjectCache
+{
+private:
+	/** The interaction interfaces implemented by each class that has been looked up. */
+	static TMap<TObjectKey<UClass>, EInteractableInterfaceFlags> ClassFlags;
+
+	/** The interactable components of each actor that has been looked up. */
+	static TMap<TObjectKey<AActor>, FInteractableComponentList> ActorComponents;
+
+	/** The bounding box volume of each actor that has been looked up. */
+	static TMap<TObjectKey<AActor>, FInteractableActorBounds> ActorBounds;
+
+	/** Handle for the world cleanup delegate that empties the cache. */
+	static FDelegateHandle WorldCleanupDelegateHandle;
+
+	/** The amount of actor entries at which entries of destroyed actors are removed. */
+	static int32 ActorPruneThreshold;
+
+	/** The minimum value of ActorPruneThreshold. */
+	static constexpr int32 MinActorPruneThreshold {256};
+
+public:
+	/** Returns the interaction interfaces implemented by a class. */
+	static EInteractableInterfaceFlags GetClassFlags(const UClass* Class);
+
+	/** Returns the interactable components of an actor. Returns a nullptr if the actor is invalid.
+	 *	The list is only rebuilt when the component stamp of the actor no longer matches, see FInteractableComponentStamp. */
+	static const FInteractableComponentList* GetInteractableComponents(const AActor* Actor);
+
+	/** Returns the volume of the extent of the world space bounding box of an actor's components.
+	 *	The extent does not depend on the actor's location, so it is only recalculated when the actor rotates or scales,
+	 *	or when the component stamp of the actor no longer matches. */
+	static float GetBoundingBoxVolume(const AActor* Actor);
+
+	/** Removes all cached classes and actors. */
+	static void Reset();
+
+private:
+	/** Registers the delegate that empties the cache when a world is cleaned up. */
+	static void RegisterWorldCleanup();
+
+	/** Removes the entries of destroyed actors once the amount of actor entries reaches ActorPruneThreshold,
+	 *	so that the cache does not grow for the lifetime of the world in levels that spawn and destroy many actors. */
+	static void PruneDestroyedActors();
+
+public:
+
+	/** Returns the flag for an interaction interface. */
+	template <typename TInterface>
+	static constexpr EInteractableInterfaceFlags GetInterfaceFlag()
+	{
+		if constexpr (TIsSame<TInterface, UInteractableObject>::Value) { return EInteractableInterfaceFlags::InteractableObject; }
+		else if constexpr (TIsSame<TInterface, UUsableObject>::Value) { return EInteractableInterfaceFlags::UsableObject; }
+		else if constexpr (TIsSame<TInterface, UGrabbableObject>::Value) { return EInteractableInterfaceFlags::GrabbableObject; }
+		else if constexpr (TIsSame<TInterface, UDraggableObject>::Value) { return EInteractableInterfaceFlags::DraggableObject; }
+		else
+		{
+			static_assert(sizeof(TInterface) == 0, "FInteractableObjectCache only supports the interaction interfaces.");
+			return EInteractableInterfaceFlags::None;
+		}
+	}
+
+	/** Returns the actor, or the first component of the actor, that implements the specified interface. */
+	template <typename TInterface>
+	static UObject* FindObject(AActor* Actor)
+	{
+		if (!Actor) { return nullptr; }
+
+		if (EnumHasAnyFlags(GetClassFlags(Actor->GetClass()), GetInterfaceFlag<TInterface>()))
+		{
+			return Actor;
+		}
+		return FindComponent<TInterface>(Actor);
+	}
+
+	/** Returns the first component of the actor that implements the specified interface. */
+	template <typename TInterface>
+	static UActorComponent* FindComponent(const AActor* Actor)
+	{
+		const FInteractableComponentList* List {GetInteractableComponents(Actor)};
+		if (!List) { return nullptr; }
+
+		for (int32 Index {0}; Index < List->Components.Num(); ++Index)
+		{
+			if (EnumHasAnyFlags(List->ComponentFlags[Index], GetInterfaceFlag<TInterface>()))
+			{
+				if (UActorComponent* Component {List->Components[Index].Get()})
+				{
+					return Component;
+				}
+			}
+		}
+		return nullptr;
+	}
+
+	/** Appends the actor and all components of the actor that implement the specified interface to an array. */
+	template <typename TInterface, typename AllocatorType>
+	static void FindObjects(AActor* Actor, TArray<UObject*, AllocatorType>& OutObjects)
+	{
+		const FInteractableComponentList* List {GetInteractableComponents(Actor)};
+		if (!List) { return; }
+
+		if (EnumHasAnyFlags(List->ActorFlags, GetInterfaceFlag<TInterface>()))
+		{
+			OutObjects.Add(Actor);
+		}
+
+		for (int32 Index {0}; Index < List->Components.Num(); ++Index)
+		{
+			if (EnumHasAnyFlags(List->ComponentFlags[Index], GetInterfaceFlag<TInterface>()))
+			{
+				if (UActorComponent* Component {List->Components[Index].Get()})
+				{
+					OutObjects.Add(Component);
+				}
+			}
+		}
+	}
+};
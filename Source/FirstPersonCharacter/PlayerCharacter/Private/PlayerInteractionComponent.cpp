@@ -2,9 +2,7 @@
 // Written by Nino Saglia & Tim Verberne.
 
 #include "PlayerInteractionComponent.h"
-#include "DraggableObjectInterface.h"
-#include "GrabbableObjectInterface.h"
-#include "UsableObjectInterface.h"
+#include "InteractableObjectCache.h"
 #include "PlayerCharacter.h"
 #include "PlayerDragComponent.h"
 #include "PlayerGrabComponent.h"
@@ -54,19 +52,81 @@ void UPlayerInteractionComponent::BeginPlay()
 	{
 		DragComponent->InteractionComponent = this;
 	}
+
+	/** Reserve memory for the interactable objects up front, so that changing the interaction target does not allocate. */
+	CurrentInteractableObjects.Reserve(8);
 }
 
 void UPlayerInteractionComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
+	TimeSinceLastScan += DeltaTime;
+
 	if (GrabComponent && GrabComponent->GetGrabbedActor())
 	{
 		CurrentInteractableActor = nullptr;
+		CancelInteractionScan();
+		IsScanPending = true;
 		return;
 	}
+
+	if (PendingTraceStage != EInteractionTraceStage::None || ShouldScanForInteractableActor())
+	{
+		ScanForInteractableActor();
+	}
+	else
+	{
+		UpdateLookAtLocation();
+	}
+
+	GetClosestObjectToLocation(ClosestInteractableObject, LookAtLocation, CurrentInteractableObjects);
 	
-	if (AActor* InteractableActor {CheckForInteractableActor()})
+	if (UseComponent && UseComponent->GetActorInUse() != CurrentInteractableActor)
+	{
+		UseComponent->EndUse();
+	}
+	
+}
+
+bool UPlayerInteractionComponent::ShouldScanForInteractableActor() const
+{
+	if (IsScanPending || !Camera || ScanRate <= 0.0f) { return true; }
+
+	/** The current interactable actor might have been destroyed since the last scan. */
+	if (CurrentInteractableActor && !IsValid(CurrentInteractableActor)) { return true; }
+
+	constexpr float LocationTolerance {0.1f};
+	constexpr float RotationTolerance {1.e-4f};
+
+	const FTransform& CameraTransform {Camera->GetComponentTransform()};
+	bool IsStationary {CameraTransform.TranslationEquals(LastScanCameraTransform, LocationTolerance)
+		&& CameraTransform.RotationEquals(LastScanCameraTransform, RotationTolerance)};
+
+	if (IsStationary && !LastScanHitActor.IsExplicitlyNull())
+	{
+		const AActor* HitActor {LastScanHitActor.Get()};
+		IsStationary = HitActor && HitActor->GetActorTransform().Equals(LastScanHitActorTransform, LocationTolerance);
+	}
+
+	if (IsStationary)
+	{
+		return IdleScanRate > 0.0f && TimeSinceLastScan >= 1.0f / IdleScanRate;
+	}
+	return TimeSinceLastScan >= 1.0f / ScanRate;
+}
+
+void UPlayerInteractionComponent::ScanForInteractableActor()
+{
+	if (!AdvanceInteractionScan())
+	{
+		UpdateLookAtLocation();
+		return;
+	}
+
+	const FInteractionTraceResults& Results {GetTraceResults()};
+
+	if (AActor* InteractableActor {Results.InteractableActor})
 	{
 		if (InteractableActor != CurrentInteractableActor)
 		{
@@ -76,104 +136,205 @@ void UPlayerInteractionComponent::TickComponent(float DeltaTime, ELevelTick Tick
 	}
 	else 
 	{
-		if (!CurrentInteractableObjects.IsEmpty())
-		{
-			CurrentInteractableObjects.Empty();
-		}
+		/** Reset instead of empty the array so that its memory is reused when the next interactable actor is found. */
+		CurrentInteractableObjects.Reset();
 		CurrentInteractableActor = nullptr;
 	}
 
-	GetClosestObjectToLocation(ClosestInteractableObject, CameraTraceHitResult.Location, CurrentInteractableObjects);
-	
-	if (UseComponent && UseComponent->GetActorInUse() != CurrentInteractableActor)
+	TimeSinceLastScan = 0.0f;
+	IsScanPending = false;
+
+	LastScanHitActor = Results.CameraTraceHitResult.GetActor();
+	if (const AActor* HitActor {LastScanHitActor.Get()})
 	{
-		UseComponent->EndUse();
+		LastScanHitActorTransform = HitActor->GetActorTransform();
 	}
-	
+
+	/** The results are a frame old, so we extrapolate the look-at location from the current camera transform. */
+	LookAtLocation = Results.CameraTraceHitResult.Location;
+	UpdateLookAtLocation();
 }
 
-AActor* UPlayerInteractionComponent::CheckForInteractableActor()
+void UPlayerInteractionComponent::UpdateLookAtLocation()
 {
-	if (!Camera) { return nullptr; }
-	
-	CameraLocation = Camera->GetComponentLocation();
-	
-	/** We reset the camera trace hit result instead of constructing a new one every check to prevent unnecessary memory allocation every frame. */
-	CameraTraceHitResult.Reset(0, false);
-	
-	PerformTraceFromCamera(CameraTraceHitResult);
+	const FHitResult& CameraTraceHitResult {GetTraceResults().CameraTraceHitResult};
+	if (!Camera || !CameraTraceHitResult.IsValidBlockingHit()) { return; }
+
+	LookAtLocation = Camera->GetComponentLocation() + Camera->GetForwardVector() * CameraTraceHitResult.Distance;
+}
 
-	/** Break off the execution and return a nullptr if the camera trace did not yield a valid blocking hit. */
-	if (!CameraTraceHitResult.IsValidBlockingHit()) { return nullptr; }
+AActor* UPlayerInteractionComponent::CheckForInteractableActor() const
+{
+	return GetTraceResults().InteractableActor;
+}
+
+bool UPlayerInteractionComponent::AdvanceInteractionScan()
+{
+	UWorld* World {GetWorld()};
+	if (!Camera || !World) { return false; }
 
-	/** If the object the camera is looking at directly responds to the interactable collision channel, return that actor. */
-	if (AActor* HitActor = CameraTraceHitResult.GetActor(); HitActor &&
-		HitActor->GetRootComponent()->GetCollisionResponseToChannel(ECollisionChannel::ECC_GameTraceChannel1) == ECollisionResponse::ECR_Block)
+	FInteractionTraceResults& Results {GetPendingTraceResults()};
+
+	/** Start a new scan by issuing the camera trace. Its results will be available during the next frame. */
+	if (PendingTraceStage == EInteractionTraceStage::None)
 	{
-		/** Check if the object is small. Large objects like tables should be ignored. */
-		const FBox BoundingBox {HitActor->GetComponentsBoundingBox(true)};
-		const FVector BoxExtent {BoundingBox.GetExtent()};
-		
-		if (const float BoundingBoxVolume {static_cast<float>(BoxExtent.X * BoxExtent.Y * BoxExtent.Z)}; BoundingBoxVolume < 2000.0f)
+		/** We reset the results instead of constructing new ones every scan to prevent unnecessary memory allocation. */
+		Results.Reset();
+		Results.CameraLocation = Camera->GetComponentLocation();
+		LastScanCameraTransform = Camera->GetComponentTransform();
+		PendingTraceHandle = PerformTraceFromCamera(Results.CameraLocation);
+		PendingTraceStage = EInteractionTraceStage::CameraTrace;
+		return false;
+	}
+
+	/** The trace datum is a member so that the memory of its hit results is reused by every query. */
+	FTraceDatum& TraceDatum {PendingTraceDatum};
+	if (!World->QueryTraceData(PendingTraceHandle, TraceDatum))
+	{
+		/** The query was issued during this frame, so we wait for the next frame. If the handle expired, we restart the scan. */
+		if (!World->IsTraceHandleValid(PendingTraceHandle, false))
 		{
-			return HitActor;
+			CancelInteractionScan();
 		}
+		return false;
 	}
 
-	/** Perform a multi sphere sweep for interactable object and get the actor closest to the camera trace hit. */
-	ObjectTraceHitResults.Empty();
-	PerformInteractableObjectTrace(ObjectTraceHitResults, CameraTraceHitResult);
-	if (ObjectTraceHitResults.IsEmpty()) { return nullptr; }
-	AActor* ClosestActor {GetClosestActor(ObjectTraceHitResults, CameraTraceHitResult)};
+	switch (PendingTraceStage)
+	{
+	case EInteractionTraceStage::CameraTrace:
+		{
+			if (!TraceDatum.OutHits.IsEmpty())
+			{
+				Results.CameraTraceHitResult = TraceDatum.OutHits[0];
+			}
 
-	/** We reset the occlusion trace hit result instead of constructing a new one every check to prevent unnecessary memory allocation every frame. */
-	OcclusionTraceHitResult.Reset(0, false);
-	if (IsActorOccluded(ClosestActor)) { ClosestActor = nullptr; }
-	
-	return ClosestActor;
+			/** Complete the scan without an interactable actor if the camera trace did not yield a valid blocking hit. */
+			if (!Results.CameraTraceHitResult.IsValidBlockingHit())
+			{
+				CompleteInteractionScan(nullptr);
+				return true;
+			}
+
+			/** If the object the camera is looking at directly responds to the interactable collision channel, use that actor. */
+			if (AActor* HitActor = Results.CameraTraceHitResult.GetActor(); HitActor && HitActor->GetRootComponent() &&
+				HitActor->GetRootComponent()->GetCollisionResponseToChannel(ECollisionChannel::ECC_GameTraceChannel1) == ECollisionResponse::ECR_Block)
+			{
+				/** Check if the object is small. Large objects like tables should be ignored.
+				 *	The volume is cached per actor, as calculating the bounding box iterates all components of the actor. */
+				if (const float BoundingBoxVolume {FInteractableObjectCache::GetBoundingBoxVolume(HitActor)}; BoundingBoxVolume < 2000.0f)
+				{
+					CompleteInteractionScan(HitActor);
+					return true;
+				}
+			}
+
+			/** Perform a multi sphere sweep for interactable objects around the camera trace hit. */
+			PendingTraceHandle = PerformInteractableObjectTrace(Results.CameraTraceHitResult);
+			PendingTraceStage = EInteractionTraceStage::ObjectTrace;
+			return false;
+		}
+	case EInteractionTraceStage::ObjectTrace:
+		{
+			Results.ObjectTraceHitResults.Append(TraceDatum.OutHits);
+
+			/** Get the actor closest to the camera trace hit and check whether it is occluded. */
+			Results.InteractableActor = GetClosestActor(Results.ObjectTraceHitResults, Results.CameraTraceHitResult);
+			if (!Results.InteractableActor)
+			{
+				CompleteInteractionScan(nullptr);
+				return true;
+			}
+
+			PendingTraceHandle = PerformOcclusionTrace(Results.CameraLocation, Results.InteractableActor);
+			PendingTraceStage = EInteractionTraceStage::OcclusionTrace;
+			return false;
+		}
+	case EInteractionTraceStage::OcclusionTrace:
+		{
+			if (!TraceDatum.OutHits.IsEmpty())
+			{
+				Results.OcclusionTraceHitResult = TraceDatum.OutHits[0];
+			}
+
+			AActor* ClosestActor {Results.InteractableActor};
+			CompleteInteractionScan(IsActorOccluded(ClosestActor, Results.OcclusionTraceHitResult) ? nullptr : ClosestActor);
+			return true;
+		}
+	default:
+		return false;
+	}
+}
+
+void UPlayerInteractionComponent::CompleteInteractionScan(AActor* InteractableActor)
+{
+	GetPendingTraceResults().InteractableActor = InteractableActor;
+	FrontTraceResultsIndex ^= 1;
+	PendingTraceHandle = FTraceHandle();
+	PendingTraceStage = EInteractionTraceStage::None;
+}
+
+void UPlayerInteractionComponent::CancelInteractionScan()
+{
+	PendingTraceHandle = FTraceHandle();
+	PendingTraceStage = EInteractionTraceStage::None;
 }
 
-/** Performs a line trace in the direction of the camera's forward vector. */
-void UPlayerInteractionComponent::PerformTraceFromCamera(FHitResult& HitResult)
+/** Issues a line trace in the direction of the camera's forward vector. */
+FTraceHandle UPlayerInteractionComponent::PerformTraceFromCamera(const FVector& Location)
 {
-	const FVector EndLocation = CameraLocation + Camera->GetForwardVector() * CameraTraceLength;
+	const FVector EndLocation = Location + Camera->GetForwardVector() * CameraTraceLength;
 	
-	GetWorld()->LineTraceSingleByChannel(
-		HitResult,
-		CameraLocation,
+	const FTraceHandle Handle {GetWorld()->AsyncLineTraceByChannel(
+		EAsyncTraceType::Single,
+		Location,
 		EndLocation,
 		ECollisionChannel::ECC_Visibility,
 		CameraTraceQueryParams
-	);
+	)};
 
 	if (IsDebugVisEnabled)
 	{
-		DrawDebugLine(GetWorld(), CameraLocation, EndLocation, FColor::White, false, 0.0f, 0, 3.0f);
+		DrawDebugLine(GetWorld(), Location, EndLocation, FColor::White, false, 0.0f, 0, 3.0f);
 	}
+	return Handle;
 }
 
-/** Performs a multi sphere trace at the hit location of a hit result and populates and array of hit results. */
-void UPlayerInteractionComponent::PerformInteractableObjectTrace(TArray<FHitResult>& Array, const FHitResult& HitResult)
+/** Issues a multi sphere trace at the hit location of a hit result. */
+FTraceHandle UPlayerInteractionComponent::PerformInteractableObjectTrace(const FHitResult& HitResult)
 {
-	if (!GetWorld()) { return; }
-
 	FCollisionQueryParams QueryParams;
 	QueryParams.AddIgnoredActor(GetOwner());
 
-	GetWorld()->SweepMultiByChannel(
-		Array,
+	const FTraceHandle Handle {GetWorld()->AsyncSweepByChannel(
+		EAsyncTraceType::Multi,
 		HitResult.ImpactPoint,
 		HitResult.ImpactPoint,
 		FQuat::Identity,
 		ECollisionChannel::ECC_GameTraceChannel1,
 		FCollisionShape::MakeSphere(ObjectTraceRadius),
 		QueryParams
-	);
+	)};
 
 	if (IsDebugVisEnabled)
 	{
 		DrawDebugSphere(GetWorld(), HitResult.ImpactPoint, ObjectTraceRadius, 32, FColor::White, false, 0.0f, 0, 2.0f);
 	}
+	return Handle;
+}
+
+/** Issues a line trace from a location to an actor. */
+FTraceHandle UPlayerInteractionComponent::PerformOcclusionTrace(const FVector& Location, const AActor* Actor)
+{
+	FCollisionQueryParams QueryParams = FCollisionQueryParams(FName(TEXT("VisibilityTrace")), false, nullptr);
+	QueryParams.AddIgnoredActor(GetOwner());
+
+	return GetWorld()->AsyncLineTraceByChannel(
+		EAsyncTraceType::Single,
+		Location,
+		Actor->GetActorLocation() + OcclusionOffset,
+		ECollisionChannel::ECC_Visibility,
+		QueryParams
+	);
 }
 
 /** Returns the actor closest to the hit location of a hit result. */
@@ -184,11 +345,15 @@ AActor* UPlayerInteractionComponent::GetClosestActor(const TArray<FHitResult>& A
 	
 	for (const FHitResult& ObjectHitResult : Array)
 	{
-		const float CurrentDistance = FVector::DistSquared(ObjectHitResult.GetActor()->GetActorLocation(), HitResult.ImpactPoint);
+		/** The hit actor might have been destroyed since the asynchronous trace was performed. */
+		AActor* HitActor {ObjectHitResult.GetActor()};
+		if (!HitActor) { continue; }
+
+		const float CurrentDistance = FVector::DistSquared(HitActor->GetActorLocation(), HitResult.ImpactPoint);
 		if (CurrentDistance < MinDistance)
 		{
 			MinDistance = CurrentDistance;
-			ClosestActor = ObjectHitResult.GetActor();
+			ClosestActor = HitActor;
 		}
 	}
 	return ClosestActor;
@@ -197,7 +362,8 @@ AActor* UPlayerInteractionComponent::GetClosestActor(const TArray<FHitResult>& A
 template <typename TInterface>
 void UPlayerInteractionComponent::AddInteractableObjectsOfType(AActor* Actor, EInteractionType InteractionType)
 {
-	TArray<UObject*> InteractableObjects {FindInteractableObjects<TInterface>(Actor)};
+	TArray<UObject*, TInlineAllocator<8>> InteractableObjects;
+	FInteractableObjectCache::FindObjects<TInterface>(Actor, InteractableObjects);
 	if (!InteractableObjects.IsEmpty())
 	{
 		for (UObject* InteractableObject : InteractableObjects)
@@ -211,98 +377,22 @@ void UPlayerInteractionComponent::UpdateInteractableObjectData(AActor* NewIntera
 {
 	if (!NewInteractableActor) { return; }
 
-	CurrentInteractableObjects.Empty();
+	CurrentInteractableObjects.Reset();
 
 	AddInteractableObjectsOfType<UUsableObject>(NewInteractableActor, EInteractionType::Usable);
 	AddInteractableObjectsOfType<UGrabbableObject>(NewInteractableActor, EInteractionType::Grabbable);
 	AddInteractableObjectsOfType<UDraggableObject>(NewInteractableActor, EInteractionType::Draggable);
 }
 
-bool UPlayerInteractionComponent::IsActorOccluded(const AActor* Actor)
+bool UPlayerInteractionComponent::IsActorOccluded(const AActor* Actor, const FHitResult& HitResult)
 {
 	if (!Actor) { return false; }
-	
-	const FVector EndLocation = Actor->GetActorLocation();
-	FCollisionQueryParams QueryParams = FCollisionQueryParams(FName(TEXT("VisibilityTrace")), false, nullptr);
-	QueryParams.AddIgnoredActor(GetOwner());
-	
-	const bool IsHit = GetWorld()->LineTraceSingleByChannel(
-		OcclusionTraceHitResult,
-		CameraLocation,
-		EndLocation + OcclusionOffset,
-		ECollisionChannel::ECC_Visibility,
-		QueryParams
-	);
 
 	/** If the line trace hits an object other than the target actor, we assume the target actor is occluded. */
-	const bool IsOccluded = IsHit && OcclusionTraceHitResult.GetActor() && OcclusionTraceHitResult.GetActor() != Actor;
+	const bool IsOccluded = HitResult.bBlockingHit && HitResult.GetActor() && HitResult.GetActor() != Actor;
 	return IsOccluded;
 }
 
-template <typename TInterface>
-UObject* UPlayerInteractionComponent::FindInteractableObject(AActor* Actor) const
-{
-	if (!Actor) { return nullptr; }
-	UObject* InteractableObject {nullptr};
-	
-	/** Check if the actor implements the specified interface. */
-	if (Actor->GetClass()->ImplementsInterface(TInterface::StaticClass()))
-	{
-		InteractableObject = Actor;
-	}
-	
-	/** If the actor does not implement the specified interface, try to find a component that does.*/
-	else if (UActorComponent* InteractableComponent {FindInteractableComponent<TInterface>(Actor)})
-	{
-		InteractableObject = InteractableComponent;
-	}
-	
-	return InteractableObject;
-}
-
-template <typename TInterface>
-TArray<UObject*> UPlayerInteractionComponent::FindInteractableObjects(AActor* Actor) const
-{
-	TArray<UObject*> InteractableObjects;
-
-	if (!Actor) { return InteractableObjects; }
-
-	/** Check if the actor implements the specified interface. */
-	if (Actor->GetClass()->ImplementsInterface(TInterface::StaticClass()))
-	{
-		InteractableObjects.Add(Actor);
-	}
-
-	/** Iterate through the actor's components, checking if any of them implement the specified interface. */
-	TArray<UActorComponent*> Components;
-	Actor->GetComponents(Components);
-	for (UActorComponent* Component : Components)
-	{
-		if (Component->GetClass()->ImplementsInterface(TInterface::StaticClass()))
-		{
-			InteractableObjects.Add(Component);
-		}
-	}
-
-	return InteractableObjects;
-}
-
-template <typename TInterface>
-UActorComponent* UPlayerInteractionComponent::FindInteractableComponent(const AActor* Actor) const
-{
-	if (!Actor) { return nullptr; }
-	TSet<UActorComponent*> Components {Actor->GetComponents()};
-	if (Components.IsEmpty()) { return nullptr; }
-	for (UActorComponent* Component : Components)
-	{
-		if (Component->GetClass()->ImplementsInterface(TInterface::StaticClass()))
-		{
-			return Component;
-		}
-	}
-	return nullptr;
-}
-
 inline FVector GetNearestPointOnMesh(const FHitResult& HitResult, const AActor* Actor)
 {
 	FVector TargetLocation {FVector()};
@@ -351,7 +441,7 @@ AActor* UPlayerInteractionComponent::GetActorFromObject(UObject* Object) const
 	return nullptr;
 }
 
-bool UPlayerInteractionComponent::GetClosestObjectToLocation(FInteractableObjectData& OutInteractableObjectData, const FVector& Location, TArray<FInteractableObjectData> Objects)
+bool UPlayerInteractionComponent::GetClosestObjectToLocation(FInteractableObjectData& OutInteractableObjectData, const FVector& Location, const TArray<FInteractableObjectData>& Objects)
 {
 	if (Objects.IsEmpty())
 	{
@@ -402,7 +492,7 @@ void UPlayerInteractionComponent::BeginPrimaryInteraction()
 {
 	if (CurrentInteractableActor && UseComponent)
 	{
-		if (UObject* InteractableObject {FindInteractableObject<UUsableObject>(CurrentInteractableActor)})
+		if (UObject* InteractableObject {FInteractableObjectCache::FindObject<UUsableObject>(CurrentInteractableActor)})
 		{
 			UseComponent->BeginUse(InteractableObject);
 		}
@@ -425,13 +515,14 @@ void UPlayerInteractionComponent::BeginSecondaryInteraction()
 		}
 		else if (CurrentInteractableActor)
 		{
-			if (UObject* GrabbableObject {FindInteractableObject<UGrabbableObject>(CurrentInteractableActor)})
+			if (UObject* GrabbableObject {FInteractableObjectCache::FindObject<UGrabbableObject>(CurrentInteractableActor)})
 			{
 				GrabComponent->GrabActor(CurrentInteractableActor);
 			}
-			else if (UObject* DraggableObject {FindInteractableObject<UDraggableObject>(CurrentInteractableActor)})
+			else if (UObject* DraggableObject {FInteractableObjectCache::FindObject<UDraggableObject>(CurrentInteractableActor)})
 			{
 				FVector GrabLocation {FVector()};
+				const FHitResult& CameraTraceHitResult {GetTraceResults().CameraTraceHitResult};
 				if (CameraTraceHitResult.GetActor() == CurrentInteractableActor)
 				{
 					GrabLocation = CameraTraceHitResult.ImpactPoint;
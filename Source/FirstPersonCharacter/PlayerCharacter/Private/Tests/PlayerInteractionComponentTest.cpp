@@ -0,0 +1,218 @@
+// Copyright (c) 2022-present Barrelhouse. All rights reserved.
+// Written by Nino Saglia & Tim Verberne.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && ENABLE_LOW_LEVEL_MEM_TRACKER
+
+#include "PlayerInteractionComponent.h"
+#include "MeshGrabComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "GameMapsSettings.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "Tests/AutomationCommon.h"
+
+namespace PlayerInteractionComponentTest
+{
+	/** The amount of frames the component is ticked before memory is measured, so that its buffers and the async trace buffers of the world are warmed up. */
+	constexpr int32 WarmUpFrameCount {60};
+
+	/** The amount of frames in which memory is measured. */
+	constexpr int32 MeasuredFrameCount {120};
+
+	/** The amount of frames after which the prop is moved into or out of view, so that the interaction target changes. */
+	constexpr int32 FocusChangeInterval {15};
+
+	/** The distance in front of the camera at which the prop is placed while it is in view. Must be shorter than the camera trace. */
+	constexpr float PropDistance {150.0f};
+
+	/** The offset applied to the prop while it is out of view. */
+	const FVector HiddenPropOffset {0.0f, 0.0f, -100000.0f};
+
+	/** The LLM tag that the measured ticks are attributed to. */
+	const TCHAR* const LLMTagName {TEXT("PlayerInteractionTest")};
+
+	/** Returns the amount of memory in bytes that is currently attributed to the measured ticks. */
+	int64 GetMeasuredMemory()
+	{
+		return FLowLevelMemTracker::Get().GetTagAmountForTracker(ELLMTracker::Default, FName(LLMTagName), ELLMTagSet::None);
+	}
+}
+
+/** Spawns a small grabbable prop in front of the player and moves it into and out of view, so that the interaction target keeps changing.
+ *	Ticks the interaction component of the player once per frame, and checks that the ticks after the warm up do not keep any memory alive. */
+class FPlayerInteractionAllocationCommand : public IAutomationLatentCommand
+{
+private:
+	FAutomationTestBase* Test {nullptr};
+	TWeakObjectPtr<UPlayerInteractionComponent> InteractionComponent;
+	TWeakObjectPtr<AStaticMeshActor> Prop;
+	FVector PropLocation {FVector::ZeroVector};
+	int32 FrameIndex {0};
+	int32 FocusChangeCount {0};
+	int64 MeasuredMemoryAtStart {0};
+	const AActor* LastInteractableActor {nullptr};
+
+	/** Finds the interaction component of the player and spawns the prop in front of its view. Returns false if the test cannot run. */
+	bool Setup()
+	{
+		UWorld* World {AutomationCommon::GetAnyGameWorld()};
+		APlayerController* PlayerController {World ? World->GetFirstPlayerController() : nullptr};
+		const APawn* Pawn {PlayerController ? PlayerController->GetPawn() : nullptr};
+		UPlayerInteractionComponent* Component {Pawn ? Pawn->FindComponentByClass<UPlayerInteractionComponent>() : nullptr};
+		if (!Component)
+		{
+			Test->AddError(TEXT("The loaded map has no player with a PlayerInteractionComponent."));
+			return false;
+		}
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+		PropLocation = ViewLocation + ViewRotation.Vector() * PropDistance;
+
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		AStaticMeshActor* NewProp {World->SpawnActor<AStaticMeshActor>(PropLocation, FRotator::ZeroRotator, SpawnParameters)};
+		UStaticMesh* Mesh {LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"))};
+		if (!NewProp || !Mesh)
+		{
+			Test->AddError(TEXT("The interactable prop could not be spawned."));
+			return false;
+		}
+
+		/** A 20 unit cube, which is small enough to be interacted with directly. */
+		UStaticMeshComponent* MeshComponent {NewProp->GetStaticMeshComponent()};
+		MeshComponent->SetMobility(EComponentMobility::Movable);
+		MeshComponent->SetStaticMesh(Mesh);
+		NewProp->SetActorScale3D(FVector(0.2f));
+
+		UMeshGrabComponent* GrabComponent {NewObject<UMeshGrabComponent>(NewProp)};
+		GrabComponent->SetupAttachment(MeshComponent);
+		GrabComponent->RegisterComponent();
+
+		/** The grab component enables physics, which would let the prop fall out of view on its own. */
+		MeshComponent->SetSimulatePhysics(false);
+
+		/** The component is ticked by the test instead, so that only its own tick is measured. */
+		Prop = NewProp;
+		InteractionComponent = Component;
+		Component->SetComponentTickEnabled(false);
+		return true;
+	}
+
+	/** Destroys the prop and lets the component tick on its own again. */
+	void Teardown()
+	{
+		if (AStaticMeshActor* SpawnedProp {Prop.Get()})
+		{
+			SpawnedProp->Destroy();
+		}
+
+		if (UPlayerInteractionComponent* Component {InteractionComponent.Get()})
+		{
+			Component->SetComponentTickEnabled(true);
+		}
+	}
+
+public:
+	explicit FPlayerInteractionAllocationCommand(FAutomationTestBase* InTest)
+		: Test(InTest)
+	{
+	}
+
+	virtual bool Update() override
+	{
+		using namespace PlayerInteractionComponentTest;
+
+		if (FrameIndex == 0 && !Setup())
+		{
+			Teardown();
+			return true;
+		}
+
+		UPlayerInteractionComponent* Component {InteractionComponent.Get()};
+		AStaticMeshActor* SpawnedProp {Prop.Get()};
+		if (!Component || !SpawnedProp)
+		{
+			Test->AddError(TEXT("The interaction component or the prop was destroyed during the test."));
+			Teardown();
+			return true;
+		}
+
+		/** LLM collects the amounts of the previous frame at the end of every frame, so the results are read one frame after the last measured tick. */
+		if (FrameIndex == WarmUpFrameCount + MeasuredFrameCount)
+		{
+			const int64 RetainedMemory {GetMeasuredMemory() - MeasuredMemoryAtStart};
+			Teardown();
+
+			Test->AddInfo(FString::Printf(TEXT("%d focus changes in %d ticks, %lld bytes retained."), FocusChangeCount, MeasuredFrameCount, RetainedMemory));
+			Test->TestTrue(TEXT("The interaction target changed during the measured ticks"), FocusChangeCount > 0);
+			Test->TestEqual(TEXT("Memory retained by steady state ticks"), RetainedMemory, static_cast<int64>(0));
+			return true;
+		}
+
+		if (FrameIndex % FocusChangeInterval == 0)
+		{
+			const bool IsInView {(FrameIndex / FocusChangeInterval) % 2 == 0};
+			SpawnedProp->SetActorLocation(IsInView ? PropLocation : PropLocation + HiddenPropOffset, false, nullptr, ETeleportType::TeleportPhysics);
+		}
+
+		const float DeltaTime {Component->GetWorld() ? Component->GetWorld()->GetDeltaSeconds() : 0.0f};
+		if (FrameIndex < WarmUpFrameCount)
+		{
+			Component->TickComponent(DeltaTime, LEVELTICK_All, nullptr);
+		}
+		else
+		{
+			if (FrameIndex == WarmUpFrameCount)
+			{
+				MeasuredMemoryAtStart = GetMeasuredMemory();
+			}
+
+			{
+				LLM_SCOPE_BYNAME(LLMTagName);
+				Component->TickComponent(DeltaTime, LEVELTICK_All, nullptr);
+			}
+
+			if (Component->GetCurrentInteractableActor() != LastInteractableActor)
+			{
+				++FocusChangeCount;
+			}
+		}
+
+		LastInteractableActor = Component->GetCurrentInteractableActor();
+		++FrameIndex;
+		return false;
+	}
+};
+
+/** Checks that the interaction component of the player does not keep memory allocated by its ticks while the interaction target changes.
+ *	Memory is attributed with LLM, so this only detects allocations that outlive the measured ticks, such as buffers that are released and allocated again.
+ *	Run headless with: UnrealEditor-Cmd <Project>.uproject -game -nullrhi -nosound -llm -ExecCmds="Automation RunTests FirstPersonCharacter.PlayerInteraction.SteadyStateAllocations; Quit" */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlayerInteractionSteadyStateAllocationsTest, "FirstPersonCharacter.PlayerInteraction.SteadyStateAllocations",
+	EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+bool FPlayerInteractionSteadyStateAllocationsTest::RunTest(const FString& Parameters)
+{
+	if (!FLowLevelMemTracker::IsEnabled())
+	{
+		AddError(TEXT("LLM is disabled. Run the test with -llm."));
+		return false;
+	}
+
+	const FString MapName {UGameMapsSettings::GetGameDefaultMap()};
+	if (!AutomationOpenMap(MapName))
+	{
+		AddError(FString::Printf(TEXT("Failed to open map '%s'."), *MapName));
+		return false;
+	}
+
+	ADD_LATENT_AUTOMATION_COMMAND(FPlayerInteractionAllocationCommand(this));
+	return true;
+}
+
+#endif
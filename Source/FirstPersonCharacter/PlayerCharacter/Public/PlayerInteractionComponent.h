@@ -5,6 +5,7 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "WorldCollision.h"
 #include "PlayerInteractionComponent.generated.h"
 
 class UPlayerGrabConfiguration;
@@ -55,6 +56,51 @@ struct FInteractableObjectData
 	}
 };
 
+/** The stage of the interaction scan that is currently in flight. */
+enum class EInteractionTraceStage : uint8
+{
+	None,
+	CameraTrace,
+	ObjectTrace,
+	OcclusionTrace
+};
+
+/** The results of the scene queries performed by a single interaction scan. */
+USTRUCT()
+struct FInteractionTraceResults
+{
+	GENERATED_BODY()
+
+	/** The location of the camera at the start of the scan. */
+	UPROPERTY()
+	FVector CameraLocation {FVector::ZeroVector};
+
+	/** The hit result for the initial visibility line trace collision query performed from the camera. */
+	UPROPERTY()
+	FHitResult CameraTraceHitResult {FHitResult()};
+
+	/** The array of hit results for the interactable object multi sphere trace. */
+	UPROPERTY()
+	TArray<FHitResult> ObjectTraceHitResults;
+
+	/** The hit result for the occlusion line trace collision query performed from the camera. */
+	UPROPERTY()
+	FHitResult OcclusionTraceHitResult {FHitResult()};
+
+	/** The interactable actor that was found by the scan. */
+	UPROPERTY()
+	AActor* InteractableActor {nullptr};
+
+	/** Resets the results without releasing allocated memory. */
+	void Reset()
+	{
+		CameraLocation = FVector::ZeroVector;
+		CameraTraceHitResult.Reset(0, false);
+		ObjectTraceHitResults.Reset();
+		OcclusionTraceHitResult.Reset(0, false);
+		InteractableActor = nullptr;
+	}
+};
 
 /** PlayerCharacter component that checks for interactable objects in front of the player character. */
 UCLASS(Blueprintable, BlueprintType, ClassGroup = "PlayerCharacter",
@@ -72,6 +118,16 @@ public:
 	UPROPERTY(EditDefaultsOnly, Category = "PlayerInteraction", Meta = (DisplayName = "Object Trace Radius", ClampMax = "500", UIMax = "500"))
 	uint16 ObjectTraceRadius {50};
 
+	/** The amount of times per second the component scans for interactable actors. In between scans, the previous result is kept
+	 *	and the look-at location is extrapolated from the camera. A value of 0 will scan every frame. */
+	UPROPERTY(EditDefaultsOnly, Category = "PlayerInteraction", Meta = (DisplayName = "Scan Rate", Units = "Hertz", ClampMin = "0", ClampMax = "120", UIMin = "0", UIMax = "120"))
+	float ScanRate {20.0f};
+
+	/** The amount of times per second the component scans for interactable actors while neither the camera nor the actor hit by the camera trace has moved.
+	 *	A value of 0 will skip scanning entirely while nothing moves. */
+	UPROPERTY(EditDefaultsOnly, Category = "PlayerInteraction", Meta = (DisplayName = "Idle Scan Rate", Units = "Hertz", ClampMin = "0", ClampMax = "120", UIMin = "0", UIMax = "120"))
+	float IdleScanRate {4.0f};
+
 private:
 	/** The use component that is used to use actors. */
 	UPROPERTY(BlueprintGetter = GetUseComponent)
@@ -93,27 +149,28 @@ private:
 	UPROPERTY(BlueprintGetter = GetIsTertiaryInteractionActive)
 	bool IsTertiaryInteractionActive {false};
 	
-	/** The location of the camera. */
-	UPROPERTY()
-	FVector CameraLocation;
-	
-	/** The hit result for the initial visibility line trace collision query performed from the camera. */
+	/** Double buffered results of the interaction scene queries. The front buffer holds the results of the last completed scan,
+	 *	while the back buffer is written to by the scan that is currently in flight. */
 	UPROPERTY()
-	FHitResult CameraTraceHitResult {FHitResult()};
+	FInteractionTraceResults TraceResults[2];
 
-	/** The hit result for the occlusion line trace collision query performed from the camera. */
-	UPROPERTY()
-	FHitResult OcclusionTraceHitResult {FHitResult()};
+	/** The index of the front buffer in the trace results. */
+	uint8 FrontTraceResultsIndex {0};
+
+	/** The handle of the asynchronous scene query that is currently in flight. */
+	FTraceHandle PendingTraceHandle;
+
+	/** The trace data that the results of the asynchronous scene queries are copied to. */
+	FTraceDatum PendingTraceDatum;
+
+	/** The stage of the interaction scan that is currently in flight. */
+	EInteractionTraceStage PendingTraceStage {EInteractionTraceStage::None};
 
 	/** The offset used for the occlusion trace. Prevents the occlusion trace hitting the actor underneath
 	 *	the interactable object that the occlusion trace is performed for. */
 	UPROPERTY()
 	FVector OcclusionOffset {FVector(0, 0, 5)};
 
-	/** The array of hit results for the interactable object multi sphere trace. */
-	UPROPERTY()
-	TArray<FHitResult> ObjectTraceHitResults;
-
 	/** The actor that currently can be interacted with. Will be a nullptr if no object can be interacted with at the moment. */
 	UPROPERTY(BlueprintGetter = GetCurrentInteractableActor)
 	AActor* CurrentInteractableActor;
@@ -125,6 +182,24 @@ private:
 	/** The closest interactable object to the camera. */
 	UPROPERTY()
 	FInteractableObjectData ClosestInteractableObject;
+
+	/** The location the player is looking at. Updated by every scan, and extrapolated from the camera in between scans. */
+	FVector LookAtLocation {FVector::ZeroVector};
+
+	/** The time in seconds since the last scan for interactable actors. */
+	float TimeSinceLastScan {0.0f};
+
+	/** If true, the next tick will scan for interactable actors regardless of the scan rate. */
+	bool IsScanPending {true};
+
+	/** The transform of the camera at the time of the last scan. */
+	FTransform LastScanCameraTransform {FTransform::Identity};
+
+	/** The actor that was hit by the camera trace during the last scan. */
+	TWeakObjectPtr<AActor> LastScanHitActor;
+
+	/** The transform of the actor that was hit by the camera trace at the time of the last scan. */
+	FTransform LastScanHitActorTransform {FTransform::Identity};
 	
 	/** The actor that is currently being interacted with. */
 	UPROPERTY(BlueprintReadOnly, Category = "PlayerInteraction", Meta = (DisplayName = "Current Interacting Actor", AllowPrivateAccess = "true"))
@@ -198,9 +273,9 @@ protected:
 	virtual void OnUnregister() override;
 	virtual void BeginPlay() override;
 	 
-	/** Checks if any interactable objects are in front of the player. */
-	UFUNCTION(BlueprintCallable, Category = "PlayerInteractionComponent", Meta = (DisplayName = "Check For Interactable Objects", BlueprintProtected))
-	AActor* CheckForInteractableActor();
+	/** Returns the interactable actor found by the last completed scan. Scans are advanced by the tick of the component only. */
+	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "PlayerInteractionComponent", Meta = (DisplayName = "Check For Interactable Objects", BlueprintProtected))
+	AActor* CheckForInteractableActor() const;
 
 	UFUNCTION(BlueprintNativeEvent, Category = "PlayerInteraction", Meta = (DisplayName = "Begin Interaction"))
 	void EventBeginInteraction(const EInteractionActionType Type, const UObject* Object);
@@ -209,32 +284,44 @@ protected:
 	void EventEndInteraction(const EInteractionActionType Type, const UObject* Object);
 
 private:
-	/** Performs a line trace from the camera. */
-	UFUNCTION()
-	void PerformTraceFromCamera(FHitResult& HitResult);
+	/** Returns whether the component should scan for interactable actors this tick.
+	 *	Scans are performed at the scan rate, or at the idle scan rate if the camera and the actor hit by the last camera trace have not moved. */
+	bool ShouldScanForInteractableActor() const;
 
-	/** Performs a multi sphere trace for objects that respond to the interactable trace channel. */
-	UFUNCTION()
-	void PerformInteractableObjectTrace(TArray<FHitResult>& Array, const FHitResult& HitResult);
+	/** Advances the scan for an interactable actor, and updates the current interactable actor and objects once the scan completes. */
+	void ScanForInteractableActor();
+
+	/** Advances the asynchronous scan by consuming the results of the scene query issued during the previous frame,
+	 *	and issuing the next scene query if required. Starts a new scan if none is in flight.
+	 *	Each query depends on the result of the one before it, so a scan completes one frame after it starts if the camera hits a small interactable actor,
+	 *	and at most three frames after it starts otherwise. At the default scan rate and 60 frames per second, that fits within the interval between two scans,
+	 *	so the interaction target lags by at most one scan interval, while the look-at location is extrapolated from the camera every frame.
+	 *	Returns true if the scan completed and its results were moved to the front buffer. */
+	bool AdvanceInteractionScan();
+
+	/** Completes the scan that is in flight and swaps the trace result buffers. */
+	void CompleteInteractionScan(AActor* InteractableActor);
+
+	/** Cancels the scan that is in flight, if any. */
+	void CancelInteractionScan();
+
+	/** Extrapolates the look-at location from the current camera transform and the distance of the last camera trace hit. */
+	void UpdateLookAtLocation();
+
+	/** Issues an asynchronous line trace from the camera. */
+	FTraceHandle PerformTraceFromCamera(const FVector& Location);
+
+	/** Issues an asynchronous multi sphere trace for objects that respond to the interactable trace channel. */
+	FTraceHandle PerformInteractableObjectTrace(const FHitResult& HitResult);
+
+	/** Issues an asynchronous line trace from a location towards an actor, used to check whether the actor is occluded. */
+	FTraceHandle PerformOcclusionTrace(const FVector& Location, const AActor* Actor);
 
 	/** Returns the closest object to the specified hit hit result from an array of hit results. */
 	UFUNCTION()
 	static AActor* GetClosestActor(const TArray<FHitResult>& Array, const FHitResult& HitResult);
 
-	/** Checks if an actor or one of its components implements the IInteractableObject interface.
-	 *	Returns the first UObject that implements the interface that it finds. */
-	template <typename TInterface>
-	UObject* FindInteractableObject(AActor* Actor) const;
-
-	/** Tries to find a component that implements the IInteractableObject interface in a specified actor.*/
-	template <typename TInterface>
-	UActorComponent* FindInteractableComponent(const AActor* Actor) const;
-
-	/** Checks if an actor or one of its components implements the IInteractableObject interface.
-	*	Returns all UObjects that implements the interface that it finds. */
-	template <typename TInterface>
-	TArray<UObject*> FindInteractableObjects(AActor* Actor) const;
-	
+	/** Adds the actor and all components of the actor that implement the specified interface to the current interactable objects. */
 	template <class TInterface>
 	void AddInteractableObjectsOfType(AActor* Actor, EInteractionType InteractionType);
 
@@ -242,9 +329,9 @@ private:
 	UFUNCTION()
 	void UpdateInteractableObjectData(AActor* NewInteractableActor);
 
-	/** Checks whether an actor is occluded. Is used to prevent the interaction component from highlighting objects behind walls or other objects. */
-	UFUNCTION()
-	bool IsActorOccluded(const AActor* Actor);
+	/** Checks whether an actor is occluded according to the result of an occlusion trace.
+	 *	Is used to prevent the interaction component from highlighting objects behind walls or other objects. */
+	static bool IsActorOccluded(const AActor* Actor, const FHitResult& HitResult);
 	
 	/** Converts a UObject pointer to an AActor pointer.
 	 *	Either by checking if the UObject is an AActor,
@@ -253,7 +340,7 @@ private:
 	AActor* GetActorFromObject(UObject* Object) const;
 
 	/** Returns the closest USceneComponent to the player's look-at location. */
-	bool GetClosestObjectToLocation(FInteractableObjectData& OutInteractableObjectData, const FVector& Location, TArray<FInteractableObjectData> Objects);
+	bool GetClosestObjectToLocation(FInteractableObjectData& OutInteractableObjectData, const FVector& Location, const TArray<FInteractableObjectData>& Objects);
 
 public:
 	/** Returns a pointer to the use component. */
@@ -298,8 +385,15 @@ public:
 		return true;
 	}
 
-	/** Returns the most recent camera trace result. */
+	/** Returns the camera trace result of the last completed scan. */
 	UFUNCTION(BlueprintPure)
-	FORCEINLINE FHitResult GetCameraTraceHitResult() const { return CameraTraceHitResult; }
+	FORCEINLINE FHitResult GetCameraTraceHitResult() const { return GetTraceResults().CameraTraceHitResult; }
+
+	/** Returns the results of the last completed scan. */
+	FORCEINLINE const FInteractionTraceResults& GetTraceResults() const { return TraceResults[FrontTraceResultsIndex]; }
+
+private:
+	/** Returns the results of the scan that is currently in flight. */
+	FORCEINLINE FInteractionTraceResults& GetPendingTraceResults() { return TraceResults[FrontTraceResultsIndex ^ 1]; }
 };
 